@@ -1089,14 +1089,14 @@ void BSDetectionWidget::writeDetectionStatus ()
 void BSDetectionWidget::saveMask ()
 {
       QImage mim (width, height, QImage::Format_RGB32);
-      bool *mask = gMap->getMask ();
       int nb = 0;
       for (int j = 0; j < height; j++)
         for (int i = 0; i < width; i++)
         {
-          if (*mask) nb++;
+          bool occ = ! gMap->isFree (Pt2i (i, j));
+          if (occ) nb++;
           mim.setPixel (i, height - 1 - j,
-                        *mask++ ? 0 : 255 + 255 * 256 + 255 * 256 * 256);
+                        occ ? 0 : 255 + 255 * 256 + 255 * 256 * 256);
         }
       mim.save ("mask.png");
       cout << "mask.png created with " << nb << " points" << endl;
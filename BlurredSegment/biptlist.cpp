@@ -1,9 +1,15 @@
 #include "biptlist.h"
 
 
+const int BiPtList::DEFAULT_CAPACITY = 64;
+
+
 BiPtList::BiPtList (Pt2i pt)
 {
-  pts.push_back (pt);
+  capacity = DEFAULT_CAPACITY;
+  pts = new Pt2i[capacity];
+  head = capacity / 2;
+  pts[head] = pt;
   start = 0;
   cpt = 1;
 }
@@ -11,12 +17,27 @@ BiPtList::BiPtList (Pt2i pt)
 
 BiPtList::~BiPtList ()
 {
+  delete [] pts;
+}
+
+
+void BiPtList::grow ()
+{
+  int ncap = 2 * capacity;
+  Pt2i *npts = new Pt2i[ncap];
+  int nhead = (ncap - cpt) / 2;
+  for (int i = 0; i < cpt; i++) npts[nhead + i] = pts[head + i];
+  delete [] pts;
+  pts = npts;
+  capacity = ncap;
+  head = nhead;
 }
 
 
 void BiPtList::addFront (Pt2i pt)
 {
-  pts.push_front (pt);
+  if (head == 0) grow ();
+  pts[--head] = pt;
   start++;
   cpt++;
 }
@@ -24,7 +45,8 @@ void BiPtList::addFront (Pt2i pt)
 
 void BiPtList::addBack (Pt2i pt)
 {
-  pts.push_back (pt);
+  if (head + cpt == capacity) grow ();
+  pts[head + cpt] = pt;
   cpt++;
 }
 
@@ -32,7 +54,8 @@ void BiPtList::addBack (Pt2i pt)
 void BiPtList::removeFront (int n)
 {
   if (n >= frontSize ()) n = frontSize () - 1; // We keep at least one point
-  for (int i = 0; i < n; i++) pts.pop_front ();
+  if (n < 0) n = 0;
+  head += n;
   cpt -= n;
   start -= n;
   if (start < 0) start = 0; // Theoretically impossible
@@ -42,7 +65,7 @@ void BiPtList::removeFront (int n)
 void BiPtList::removeBack (int n)
 {
   if (n >= backSize ()) n = backSize () - 1;  // We keep at least one point
-  for (int i = 0; i < n; i++) pts.pop_back ();
+  if (n < 0) n = 0;
   cpt -= n;
   if (start >= cpt) start = cpt - 1;  // Theoretically impossible
 }
@@ -50,12 +73,13 @@ void BiPtList::removeBack (int n)
 
 void BiPtList::findExtrema (int &xmin, int &ymin, int &xmax, int &ymax) const
 {
-  deque<Pt2i>::const_iterator it = pts.begin ();
+  const Pt2i *it = pts + head;
+  const Pt2i *end = it + cpt;
   xmin = it->x ();
   ymin = it->y ();
   xmax = it->x ();
   ymax = it->y ();
-  while (it != pts.end ())
+  while (it != end)
   {
     if (xmin > it->x ()) xmin = it->x ();
     if (xmax < it->x ()) xmax = it->x ();
@@ -68,11 +92,7 @@ void BiPtList::findExtrema (int &xmin, int &ymin, int &xmax, int &ymax) const
 
 vector<Pt2i> BiPtList::frontToBackPoints () const
 {
-  vector<Pt2i> res;
-  for (deque<Pt2i>::const_iterator it = pts.begin ();
-       it != pts.end (); it++)
-    res.push_back (*it);
-  return (res);
+  return (points().toVector ());
 }
 
 
@@ -85,18 +105,11 @@ vector<Pt2i> *BiPtList::vide () const
 vector<Pt2i> *BiPtList::frontPoints () const
 {
   // Fournis du bord au centre : pertinent ?
-  vector<Pt2i> *res = new vector<Pt2i> ();
-  deque<Pt2i>::const_iterator it = pts.begin ();
-  for (int i = 0; i < start; i++) res->push_back (*it++);
-  return res;
+  return (new vector<Pt2i> (frontSpan().toVector ()));
 }
 
 
 vector<Pt2i> *BiPtList::backPoints () const
 {
-  vector<Pt2i> *res = new vector<Pt2i> ();
-  deque<Pt2i>::const_iterator it = pts.begin ();
-  it += start + 1;
-  for (int i = 0; i < cpt - start - 1; i++) res->push_back (*it++);
-  return res;
+  return (new vector<Pt2i> (backSpan().toVector ()));
 }
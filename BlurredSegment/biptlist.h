@@ -2,7 +2,8 @@
 #define BIPT_LIST_H
 
 #include "pt2i.h"
-#include <deque>
+#include "ptspan.h"
+#include <vector>
 
 using namespace std;
 
@@ -10,6 +11,9 @@ using namespace std;
 /** 
  * @class BiPtList biptlist.h
  * \brief Bi-directional list of points.
+ * Points are stored in a contiguous buffer that grows on both sides,
+ *   so that they can be walked through read-only views (PtSpan).
+ * Views are only valid until the next modification of the list.
  * \author {P. Even}
  */
 class BiPtList
@@ -45,23 +49,23 @@ public:
   /**
    * Returns the initial point of the bi-directional list.
    */
-  inline Pt2i initialPoint () const { return (pts[start]); }
+  inline Pt2i initialPoint () const { return (pts[head + start]); }
 
   /**
    * Returns the back end point of the bi-directional list.
    */
-  inline Pt2i backPoint () const { return (pts.back ()); }
+  inline Pt2i backPoint () const { return (pts[head + cpt - 1]); }
 
   /**
    * Returns the front end point of the bi-directional list.
    */
-  inline Pt2i frontPoint () const { return (pts.front ()); }
+  inline Pt2i frontPoint () const { return (pts[head]); }
 
   /**
    * Returns the height of the point to the line between the list end points..
    */
   inline AbsRat heightToEnds (const Pt2i &pt) const {
-    return (pt.triangleRationalHeight (pts.front (), pts.back ())); }
+    return (pt.triangleRationalHeight (pts[head], pts[head + cpt - 1])); }
 
   /**
    * Adds the point on front side.
@@ -96,6 +100,24 @@ public:
    */
   void findExtrema (int &xmin, int &ymin, int &xmax, int &ymax) const;
 
+  /**
+   * Returns a view on front to back points.
+   */
+  inline PtSpan points () const { return (PtSpan (pts + head, cpt)); }
+
+  /**
+   * Returns a view on front points.
+   * Front points are viewed from segment edge to the initial point excluded.
+   */
+  inline PtSpan frontSpan () const { return (PtSpan (pts + head, start)); }
+
+  /**
+   * Returns a view on back points.
+   * Back points are viewed from initial point excluded to segment edge.
+   */
+  inline PtSpan backSpan () const {
+    return (PtSpan (pts + head + start + 1, cpt - start - 1)); }
+
   /**
    * Returns front to back points in a vector.
    */
@@ -109,23 +131,38 @@ public:
   /**
    * Returns a pointer to a vector filled in with front points.
    * Front points are entered from segment edge to the initial point excluded.
+   * The vector should be deleted by the caller (prefer frontSpan).
    */
   vector<Pt2i> *frontPoints () const;
 
   /**
    * Returns a pointer to a vector filled in with back points.
    * Back points are entered from initial point excluded to segment edge.
+   * The vector should be deleted by the caller (prefer backSpan).
    */
   vector<Pt2i> *backPoints () const;
 
 
 private:
 
-  /** List of points. */
-  deque<Pt2i> pts;
-  /** Index of the initial point. */
+  /** Default size of the point buffer. */
+  static const int DEFAULT_CAPACITY;
+
+  /** Point buffer. */
+  Pt2i *pts;
+  /** Size of the point buffer. */
+  int capacity;
+  /** Index of the front point in the buffer. */
+  int head;
+  /** Index of the initial point (from front point). */
   int start;
   /** Length of the point list. */
   int cpt;
+
+
+  /**
+   * Reallocates the point buffer with free room on both sides.
+   */
+  void grow ();
 };
 #endif
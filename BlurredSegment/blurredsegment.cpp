@@ -111,12 +111,12 @@ Vr2i BlurredSegment::boundingBoxSize () const
 vector <vector <Pt2i> > BlurredSegment::connectedComponents () const
 {
   vector <vector <Pt2i> > ccs;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
     vector <Pt2i> cc;
     bool started = false;
-    vector <Pt2i>::const_iterator it = pts.begin ();
+    const Pt2i *it = pts.begin ();
     Pt2i pix = *it++;
     while (it != pts.end ())
     {
@@ -148,11 +148,11 @@ vector <vector <Pt2i> > BlurredSegment::connectedComponents () const
 int BlurredSegment::countOfConnectedPoints () const
 {
   int count = 0;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
     bool started = false;
-    vector <Pt2i>::const_iterator it = pts.begin ();
+    const Pt2i *it = pts.begin ();
     Pt2i pix = *it++;
     while (it != pts.end ())
     {
@@ -179,11 +179,11 @@ int BlurredSegment::countOfConnectedPoints () const
 int BlurredSegment::countOfConnectedComponents () const
 {
   int count = 0;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
     bool started = false;
-    vector <Pt2i>::const_iterator it = pts.begin ();
+    const Pt2i *it = pts.begin ();
     Pt2i pix = *it++;
     while (it != pts.end ())
     {
@@ -209,11 +209,11 @@ int BlurredSegment::countOfConnectedComponents () const
 int BlurredSegment::countOfConnectedPoints (int min) const
 {
   int count = 0;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
     int cpt = 1;
-    vector <Pt2i>::const_iterator it = pts.begin ();
+    const Pt2i *it = pts.begin ();
     Pt2i pix = *it++;
     while (it != pts.end ())
     {
@@ -233,11 +233,11 @@ int BlurredSegment::countOfConnectedPoints (int min) const
 int BlurredSegment::countOfConnectedComponents (int min) const
 {
   int count = 0;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
     int cpt = 1;
-    vector <Pt2i>::const_iterator it = pts.begin ();
+    const Pt2i *it = pts.begin ();
     Pt2i pix = *it++;
     while (it != pts.end ())
     {
@@ -257,11 +257,11 @@ vector <vector <Pt2i> >
 BlurredSegment::getConnectedComponents () const
 {
   vector < vector <Pt2i> > res;
-  vector <Pt2i> pts = getAllPoints ();
+  PtSpan pts = getPointSpan ();
   if (pts.size () > 1)
   {
-    vector <Pt2i>::const_iterator bit = pts.begin ();
-    vector <Pt2i>::const_iterator eit = pts.end ();
+    const Pt2i *bit = pts.begin ();
+    const Pt2i *eit = pts.end ();
     while (bit != eit)
     {
       vector <Pt2i> lres;
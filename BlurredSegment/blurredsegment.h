@@ -93,6 +93,25 @@ public:
    */
   vector<Pt2i> getAllPoints () const;
 
+  /**
+   * \brief Returns a view on all the points of the blurred segment.
+   * Points are ordered from the left end point up to the right end point.
+   * The view is valid as long as the blurred segment is not modified.
+   */
+  inline PtSpan getPointSpan () const { return plist->points (); }
+
+  /**
+   * \brief Returns a view on the points on the left part of the segment.
+   * Points are ordered from the furthest to the nearest to the start point.
+   */
+  inline PtSpan getLeftSpan () const { return plist->frontSpan (); }
+
+  /**
+   * \brief Returns a view on the points on the right part of the segment.
+   * Points are ordered from the nearest to the furthest to the start point.
+   */
+  inline PtSpan getRightSpan () const { return plist->backSpan (); }
+
   /**
    * \brief Returns the set of points on the left part of the blurred segment.
    * Points are ordered from the furthest to the nearest to the start point.
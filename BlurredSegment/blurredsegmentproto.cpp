@@ -1,7 +1,8 @@
 #include "blurredsegmentproto.h"
 
 
-BlurredSegmentProto::BlurredSegmentProto (int maxWidth, Pt2i pix)
+BlurredSegmentProto::BlurredSegmentProto (int maxWidth, Pt2i pix,
+                                          CHVertexArena *arena)
 {
   this->maxWidth.set (maxWidth);
   plist = new BiPtList (pix);
@@ -10,6 +11,7 @@ BlurredSegmentProto::BlurredSegmentProto (int maxWidth, Pt2i pix)
   bsFlat = false;
   bsOK = false;
   convexhull = NULL;
+  this->arena = arena;
   chChanged = false;
   dss = NULL;
 }
@@ -25,6 +27,7 @@ BlurredSegmentProto::BlurredSegmentProto (int maxWidth, Pt2i center,
   bsFlat = false;
   bsOK = false;
   convexhull = NULL;
+  arena = NULL;
   chChanged = false;
   dss = NULL;
 
@@ -105,7 +108,7 @@ bool BlurredSegmentProto::addLeft (Pt2i pix)
     if (height.numerator () != 0)
     {
       convexhull = new ConvexHull (pix, plist->frontPoint (),
-                                        plist->backPoint ());
+                                        plist->backPoint (), arena);
       bsOK = true;
     }
     plist->addFront (pix);
@@ -119,7 +122,7 @@ bool BlurredSegmentProto::addLeft (Pt2i pix)
     else
     {
       convexhull = new ConvexHull (pix, plist->frontPoint (),
-                                        plist->backPoint ());
+                                        plist->backPoint (), arena);
       bsOK = true;
     }
     plist->addFront (pix);
@@ -133,7 +136,7 @@ bool BlurredSegmentProto::addLeft (Pt2i pix)
     else
     {
       convexhull = new ConvexHull (pix, plist->frontPoint (),
-                                        plist->backPoint ());
+                                        plist->backPoint (), arena);
       bsOK = true;
     }
     plist->addFront (pix);
@@ -165,7 +168,7 @@ bool BlurredSegmentProto::addRight (Pt2i pix)
     if (height.numerator () != 0)
     {
       convexhull = new ConvexHull (plist->frontPoint (),
-                                   plist->backPoint (), pix);
+                                   plist->backPoint (), pix, arena);
       bsOK = true;
     }
     plist->addBack (pix);
@@ -179,7 +182,7 @@ bool BlurredSegmentProto::addRight (Pt2i pix)
     else
     {
       convexhull = new ConvexHull (plist->frontPoint (),
-                                   plist->backPoint (), pix);
+                                   plist->backPoint (), pix, arena);
       bsOK = true;
     }
     plist->addBack (pix);
@@ -193,7 +196,7 @@ bool BlurredSegmentProto::addRight (Pt2i pix)
     else
     {
       convexhull = new ConvexHull (plist->frontPoint (),
-                                   plist->backPoint (), pix);
+                                   plist->backPoint (), pix, arena);
       bsOK = true;
     }
     plist->addBack (pix);
@@ -22,8 +22,9 @@ public:
    * Creates a blurred segment prototype.
    * @param maxWidth Maximal width of the blurred segment to build
    * @param pix Central point of the blurred segment to build
+   * @param arena Vertex arena for the convex hull (NULL if not used).
    */
-  BlurredSegmentProto (int maxWidth, Pt2i pix);
+  BlurredSegmentProto (int maxWidth, Pt2i pix, CHVertexArena *arena = NULL);
 
   /**
    * Creates a blurred segment prototype with lists of points.
@@ -118,6 +119,8 @@ protected:
 
   /** Maintained convex hull of the blurred segment. */
   ConvexHull *convexhull;
+  /** Vertex arena for the convex hull (NULL if not used). */
+  CHVertexArena *arena;
 
   /** Indicates if the blurred segment is constructed. */
   bool bsOK;
@@ -1,4 +1,5 @@
 #include "bsdetector.h"
+#include <thread>
 //#include "linespacefilter.h"
 
 
@@ -34,6 +35,9 @@ const int BSDetector::DEFAULT_FINAL_MIN_SIZE = 10;
 const int BSDetector::DEFAULT_FRAGMENT_MIN_SIZE = 5;
 const int BSDetector::DEFAULT_AUTO_SWEEPING_STEP = 15;
 const int BSDetector::PRELIM_MIN_HALF_WIDTH = 10;
+const int BSDetector::TRACKING_HALF_LENGTH = 6;
+const int BSDetector::TRACKING_MIN_SIZE_RATIO = 2;
+const int BSDetector::PARALLEL_CHUNK_SIZE = 16;
 
 
 BSDetector::BSDetector ()
@@ -43,15 +47,27 @@ BSDetector::BSDetector ()
   prelimDetectionOn = false;
   staticDetOn = false;
   singleMultiOn = true;
+  parallelOn = false;
+  threadCount = 0;
 
-  bst0 = (prelimDetectionOn ? new BSTracker () : NULL);
+  chArena = new CHVertexArena ();
+  profiler = NULL;
+  bst0 = NULL;
+  if (prelimDetectionOn)
+  {
+    bst0 = new BSTracker ();
+    bst0->setVertexArena (chArena);
+  }
   bst1 = new BSTracker ();
+  bst1->setVertexArena (chArena);
   // bst1->setPixelLackTolerence (bst1->getVicinityThreshold ());
   bst2 = new BSTracker ();
+  bst2->setVertexArena (chArena);
   bstStatic = NULL;
   if (staticDetOn)
   {
     bstStatic = new BSTracker ();
+    bstStatic->setVertexArena (chArena);
     if (bstStatic->dynamicScansOn ()) bstStatic->toggleDynamicScans ();
     if (bstStatic->isAssignedThicknessControlOn ())
       bstStatic->toggleAssignedThicknessControl ();
@@ -76,6 +92,10 @@ BSDetector::BSDetector ()
   // nbSmallBS = 0;
   multiSelection = false;
   autodet = false;
+  roiX = 0;
+  roiY = 0;
+  roiWidth = 0;
+  roiHeight = 0;
   autoSweepingStep = DEFAULT_AUTO_SWEEPING_STEP;
   maxtrials = 0;
   nbtrials = 0;
@@ -99,6 +119,7 @@ BSDetector::~BSDetector ()
   if (bsf != NULL) delete bsf;
   vector <BlurredSegment *>::iterator it = mbsf.begin ();
   while (it != mbsf.end ()) delete (*it++);
+  delete chArena;
 }
 
 
@@ -113,35 +134,307 @@ void BSDetector::setGradientMap (VMap *data)
 }
 
 
+void BSDetector::setProfiler (BSProfiler *prof)
+{
+  profiler = prof;
+  if (prelimDetectionOn) bst0->setProfiler (prof);
+  if (staticDetOn) bstStatic->setProfiler (prof);
+  bst1->setProfiler (prof);
+  bst2->setProfiler (prof);
+}
+
+
 void BSDetector::detectAll ()
 {
-  autodet = true;
-  freeMultiSelection ();
-  gMap->setMasking (true);
-  gMap->clearMask ();
+  detectAll (0, 0, gMap->getWidth (), gMap->getHeight ());
+}
 
-  bool isnext = true;
-  nbtrials = 0;
-  // nbSmallBS = 0;
+
+void BSDetector::detectAll (int x0, int y0, int sizex, int sizey)
+{
   int width = gMap->getWidth ();
   int height = gMap->getHeight ();
-  for (int x = width / 2; isnext && x > 0; x -= autoSweepingStep)
-    isnext = runMultiDetection (Pt2i (x, 0), Pt2i (x, height - 1));
-  for (int x = width / 2 + autoSweepingStep;
-       isnext && x < width - 1; x += autoSweepingStep)
-    isnext = runMultiDetection (Pt2i (x, 0), Pt2i (x, height - 1));
-  for (int y = height / 2; isnext && y > 0; y -= autoSweepingStep)
-    isnext = runMultiDetection (Pt2i (0, y), Pt2i (width - 1, y));
-  for (int y = height / 2 + autoSweepingStep;
-       isnext && y < height - 1; y += autoSweepingStep)
-    isnext = runMultiDetection (Pt2i (0, y), Pt2i (width - 1, y));
-  if (maxtrials > (int) (mbsf.size ())) maxtrials = 0;
-  // cout << nbSmallBS << " petits BS elimines" << endl;
+  roiX = (x0 < 0 ? 0 : x0);
+  roiY = (y0 < 0 ? 0 : y0);
+  roiWidth = (x0 + sizex > width ? width : x0 + sizex) - roiX;
+  roiHeight = (y0 + sizey > height ? height : y0 + sizey) - roiY;
+  if (roiWidth < 0) roiWidth = 0;
+  if (roiHeight < 0) roiHeight = 0;
+
+  vector<BlurredSegment *> crossing;
+  startAutoDetection (crossing);
+
+  // Tracks segments crossing the region again with full picture scans,
+  //   then sweeps the region strokes with scans restricted to it
+  int hl = TRACKING_HALF_LENGTH + inThick;
+  bool isnext = true;
+  vector<BlurredSegment *>::iterator it = crossing.begin ();
+  while (it != crossing.end ())
+  {
+    if (isnext) isnext = runTracking (*it, hl);
+    delete (*it++);
+  }
+  if (isnext)
+  {
+    setScanArea (roiX, roiY, roiWidth, roiHeight);
+    runAutoDetection ();
+    setScanArea (0, 0, width, height);
+  }
+  else
+  {
+    if (maxtrials > (int) (mbsf.size ())) maxtrials = 0;
+    gMap->setMasking (false);
+  }
+}
 
+
+void BSDetector::trackAll ()
+{
+  if (! autodet || mbsf.empty ())
+  {
+    detectAll ();
+    return;
+  }
+  vector<BlurredSegment *> previous = mbsf;
+  mbsf.clear ();
+  roiX = 0;
+  roiY = 0;
+  roiWidth = gMap->getWidth ();
+  roiHeight = gMap->getHeight ();
+  vector<BlurredSegment *> crossing;
+  startAutoDetection (crossing);
+
+  // Tracks previous segments again (small ones are left to the sweep
+  //   to avoid their fragmentation), then sweeps the remainder
+  int hl = TRACKING_HALF_LENGTH + inThick;
+  bool isnext = true;
+  vector<BlurredSegment *>::iterator it = previous.begin ();
+  while (it != previous.end ())
+  {
+    if (isnext && (*it)->size () >= TRACKING_MIN_SIZE_RATIO * finalMinSize)
+      isnext = runTracking (*it, hl);
+    delete (*it++);
+  }
+  if (isnext) runAutoDetection ();
+  else
+  {
+    if (maxtrials > (int) (mbsf.size ())) maxtrials = 0;
+    gMap->setMasking (false);
+  }
+}
+
+
+void BSDetector::runAutoDetection ()
+{
+  if (parallelOn) detectAllInParallel ();
+  else
+  {
+    vector<Pt2i> strokes;
+    listStrokes (strokes);
+    bool isnext = true;
+    // nbSmallBS = 0;
+    for (int i = 0; isnext && i < (int) (strokes.size ()); i += 2)
+      isnext = runMultiDetection (strokes[i], strokes[i + 1]);
+    if (maxtrials > (int) (mbsf.size ())) maxtrials = 0;
+    // cout << nbSmallBS << " petits BS elimines" << endl;
+    gMap->setMasking (false);
+  }
+}
+
+
+void BSDetector::detectAllInParallel ()
+{
+  vector<Pt2i> strokes;
+  listStrokes (strokes);
+  int nbs = (int) (strokes.size ()) / 2;
+  int nbx = 0;
+  while (nbx < nbs && strokes[2 * nbx].x () == strokes[2 * nbx + 1].x ())
+    nbx ++;
+
+  // Creates the worker detectors
+  int nbth = threadCount;
+  if (nbth == 0) nbth = (int) (thread::hardware_concurrency ());
+  if (nbth > nbs / (2 * PARALLEL_CHUNK_SIZE))
+    nbth = nbs / (2 * PARALLEL_CHUNK_SIZE);
+  if (nbth < 1) nbth = 1;
+  vector<VMap *> views;
+  vector<BSDetector *> workers;
+  for (int i = 0; i < nbth; i++)
+  {
+    views.push_back (new VMap (gMap));
+    workers.push_back (createWorker (views.back ()));
+    workers.back ()->setScanArea (roiX, roiY, roiWidth, roiHeight);
+    if (profiler != NULL) workers.back ()->setProfiler (new BSProfiler ());
+  }
+
+  // Sweeps X strokes, then Y strokes, each time even chunks first,
+  //   then odd chunks on the mask of the segments found before
+  vector<bool> redone (nbs, false);
+  bool isnext = true;
+  for (int stage = 0; isnext && stage < 4; stage ++)
+  {
+    StrokeChunks chunks;
+    int first = (stage < 2 ? 0 : nbx);
+    chunks.last = (stage < 2 ? nbx : nbs);
+    for (int st = first + (stage % 2) * PARALLEL_CHUNK_SIZE;
+         st < chunks.last; st += 2 * PARALLEL_CHUNK_SIZE)
+      chunks.starts.push_back (st);
+    int nbc = (int) (chunks.starts.size ());
+    chunks.found.resize (nbc);
+    chunks.origins.resize (nbc);
+    chunks.trials.assign (nbs, 0);
+    atomic<int> next (0);
+    vector<thread> pool;
+    for (int i = 0; i < nbth; i++)
+      pool.push_back (thread (&BSDetector::sweepStrokes, workers[i],
+                              std::cref (strokes), std::cref (mbsf),
+                              std::ref (next), std::ref (chunks)));
+    for (int i = 0; i < nbth; i++) pool[i].join ();
+
+    // Merges the chunk results in stroke order
+    for (int i = 0; i < nbc; i++)
+    {
+      for (int k = 0; k < (int) (chunks.found[i].size ()); k++)
+      {
+        BlurredSegment *bs = chunks.found[i][k];
+        int st = chunks.origins[i][k];
+        if (! isnext || redone[st])
+        {
+          delete bs;
+          continue;
+        }
+        const PtSpan span = bs->getPointSpan ();
+        const Pt2i *pt = span.begin ();
+        while (pt != span.end () && gMap->isFree (*pt)) pt ++;
+        if (pt == span.end ())
+        {
+          BSPROF_START (profiler, BSProfiler::STAGE_MASK);
+          gMap->setMask (span);
+          BSPROF_STOP (profiler, BSProfiler::STAGE_MASK);
+          mbsf.push_back (bs);
+          if ((int) (mbsf.size ()) == maxtrials) isnext = false;
+        }
+        else
+        {
+          // Conflict with a segment of another chunk : runs the stroke again
+          delete bs;
+          redone[st] = true;
+          isnext = runMultiDetection (strokes[2 * st], strokes[2 * st + 1]);
+        }
+      }
+      if (isnext)
+      {
+        // Strokes run again were already counted at their new run
+        int last = chunks.starts[i] + PARALLEL_CHUNK_SIZE;
+        if (last > chunks.last) last = chunks.last;
+        for (int st = chunks.starts[i]; st < last; st++)
+          if (! redone[st]) nbtrials += chunks.trials[st];
+      }
+    }
+  }
+
+  for (int i = 0; i < nbth; i++)
+  {
+    if (profiler != NULL)
+    {
+      profiler->add (*(workers[i]->profiler));
+      delete workers[i]->profiler;
+    }
+    delete workers[i];
+    delete views[i];
+  }
+  if (maxtrials > (int) (mbsf.size ())) maxtrials = 0;
   gMap->setMasking (false);
 }
 
 
+void BSDetector::listStrokes (vector<Pt2i> &strokes) const
+{
+  int xmax = roiX + roiWidth - 1;
+  int ymax = roiY + roiHeight - 1;
+  for (int x = roiX + roiWidth / 2; x > roiX; x -= autoSweepingStep)
+  {
+    strokes.push_back (Pt2i (x, roiY));
+    strokes.push_back (Pt2i (x, ymax));
+  }
+  for (int x = roiX + roiWidth / 2 + autoSweepingStep; x < xmax;
+       x += autoSweepingStep)
+  {
+    strokes.push_back (Pt2i (x, roiY));
+    strokes.push_back (Pt2i (x, ymax));
+  }
+  for (int y = roiY + roiHeight / 2; y > roiY; y -= autoSweepingStep)
+  {
+    strokes.push_back (Pt2i (roiX, y));
+    strokes.push_back (Pt2i (xmax, y));
+  }
+  for (int y = roiY + roiHeight / 2 + autoSweepingStep; y < ymax;
+       y += autoSweepingStep)
+  {
+    strokes.push_back (Pt2i (roiX, y));
+    strokes.push_back (Pt2i (xmax, y));
+  }
+}
+
+
+BSDetector *BSDetector::createWorker (VMap *view) const
+{
+  BSDetector *det = new BSDetector ();
+  det->setGradientMap (view);
+  if (prelimDetectionOn) det->switchPreliminary ();
+  if (staticDetOn) det->setStaticDetector (true);
+  if (prefilteringOn) det->switchFiltering (STEP_INITIAL);
+  if (filteringOn) det->switchFiltering (STEP_FINAL);
+  if (prelimDetectionOn) det->bst0->copySettings (bst0);
+  if (staticDetOn) det->bstStatic->copySettings (bstStatic);
+  det->bst1->copySettings (bst1);
+  det->bst2->copySettings (bst2);
+  det->inThick = inThick;
+  det->oppositeGradientDir = oppositeGradientDir;
+  det->initialMinSize = initialMinSize;
+  det->finalFragmentationTestOn = finalFragmentationTestOn;
+  det->fragmentMinSize = fragmentMinSize;
+  det->recenteringOn = recenteringOn;
+  det->initialSparsityTestOn = initialSparsityTestOn;
+  det->finalSparsityTestOn = finalSparsityTestOn;
+  det->finalSizeTestOn = finalSizeTestOn;
+  det->finalMinSize = finalMinSize;
+  det->singleMultiOn = singleMultiOn;
+  det->autodet = true;
+  return det;
+}
+
+
+void BSDetector::sweepStrokes (const vector<Pt2i> &strokes,
+                               const vector<BlurredSegment *> &base,
+                               atomic<int> &next, StrokeChunks &chunks)
+{
+  int i;
+  while ((i = next++) < (int) (chunks.found.size ()))
+  {
+    // Starts from the mask of the segments of former stages
+    gMap->clearMask ();
+    vector<BlurredSegment *>::const_iterator it = base.begin ();
+    while (it != base.end ()) gMap->setMask ((*it++)->getPointSpan ());
+
+    int st = chunks.starts[i];
+    int last = st + PARALLEL_CHUNK_SIZE;
+    if (last > chunks.last) last = chunks.last;
+    for (; st < last; st++)
+    {
+      int nb = (int) (mbsf.size ());
+      nbtrials = 0;
+      runMultiDetection (strokes[2 * st], strokes[2 * st + 1]);
+      chunks.trials[st] = nbtrials;
+      chunks.origins[i].insert (chunks.origins[i].end (),
+                                mbsf.size () - nb, st);
+    }
+    chunks.found[i] = mbsf;
+    mbsf.clear ();
+  }
+}
+
+
 void BSDetector::detectAllWithBalancedXY ()
 {
   autodet = true;
@@ -206,8 +499,13 @@ void BSDetector::detectSelection (const Pt2i &p1, const Pt2i &p2)
     gMap->setMasking (false);
   }
   else
+  {
+    BSPROF_START (profiler, BSProfiler::STAGE_DETECT);
     if (staticDetOn) resultValue = staticDetect (p1, p2);
     else resultValue = detect (p1, p2);
+    BSPROF_STOP (profiler, BSProfiler::STAGE_DETECT);
+    BSPROF_RESULT (profiler, resultValue);
+  }
 }
 
 
@@ -226,12 +524,66 @@ void BSDetector::freeMultiSelection ()
 }
 
 
+void BSDetector::startAutoDetection (vector<BlurredSegment *> &crossing)
+{
+  gMap->setMasking (true);
+  if (! autodet || (roiX == 0 && roiY == 0 && roiWidth == gMap->getWidth ()
+                    && roiHeight == gMap->getHeight ()))
+  {
+    freeMultiSelection ();
+    gMap->clearMask ();
+  }
+  else
+  {
+    // Removes previous segments crossing the region and their mask
+    gMap->clearMask (roiX, roiY, roiWidth, roiHeight);
+    vector<BlurredSegment *> kept;
+    vector<BlurredSegment *>::iterator it = mbsf.begin ();
+    while (it != mbsf.end ())
+    {
+      PtSpan pts = (*it)->getPointSpan ();
+      const Pt2i *pt = pts.begin ();
+      while (pt != pts.end ()
+             && (pt->x () < roiX || pt->x () >= roiX + roiWidth
+                 || pt->y () < roiY || pt->y () >= roiY + roiHeight)) pt ++;
+      if (pt == pts.end ()) kept.push_back (*it);
+      else
+      {
+        gMap->clearMask (pts);
+        crossing.push_back (*it);
+      }
+      it ++;
+    }
+
+    // Restores the mask of kept segments (dilations may reach the region)
+    for (it = kept.begin (); it != kept.end (); it ++)
+      gMap->setMask ((*it)->getPointSpan ());
+    mbsf = kept;
+  }
+  autodet = true;
+  nbtrials = 0;
+}
+
+
+void BSDetector::setScanArea (int x0, int y0, int sizex, int sizey)
+{
+  if (prelimDetectionOn) bst0->setScanArea (x0, y0, sizex, sizey);
+  if (staticDetOn) bstStatic->setScanArea (x0, y0, sizex, sizey);
+  bst1->setScanArea (x0, y0, sizex, sizey);
+  bst2->setScanArea (x0, y0, sizex, sizey);
+}
+
+
 bool BSDetector::runMultiDetection (const Pt2i &p1, const Pt2i &p2)
 {
   vector<Pt2i> pts;
   p1.draw (pts, p2);
   int *locmax = new int[pts.size ()];
+  BSPROF_START (profiler, BSProfiler::STAGE_SEEDS);
   int nlm = gMap->localMax (locmax, pts);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_SEEDS);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_STROKES, 1);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_SEEDS, nlm);
   bool isnext = true;
   for (int i = 0; isnext && i < nlm; i++)
   {
@@ -245,11 +597,16 @@ bool BSDetector::runMultiDetection (const Pt2i &p1, const Pt2i &p2)
       while (isnext && nbDets != 0)
       {
         int res = RESULT_VOID;
+        BSPROF_START (profiler, BSProfiler::STAGE_DETECT);
         if (staticDetOn) res = staticDetect (p1, p2, true, ptstart);
         else res = detect (p1, p2, true, ptstart);
+        BSPROF_STOP (profiler, BSProfiler::STAGE_DETECT);
+        BSPROF_RESULT (profiler, res);
         if (res == RESULT_OK)
         {
-          gMap->setMask (bsf->getAllPoints ());
+          BSPROF_START (profiler, BSProfiler::STAGE_MASK);
+          gMap->setMask (bsf->getPointSpan ());
+          BSPROF_STOP (profiler, BSProfiler::STAGE_MASK);
           mbsf.push_back (bsf);
           bsf = NULL; // to avoid BS deletion
           if ((int) (mbsf.size ()) == maxtrials) isnext = false;
@@ -265,6 +622,78 @@ bool BSDetector::runMultiDetection (const Pt2i &p1, const Pt2i &p2)
 }
 
 
+bool BSDetector::runTracking (BlurredSegment *bs, int hl)
+{
+  // Finds the free gradient maximum closest to the segment center
+  //   along a short stroke across it
+  int width = gMap->getWidth ();
+  int height = gMap->getHeight ();
+  Pt2i pc = bs->getCenter ();
+  if (pc.x () < 0 || pc.x () >= width || pc.y () < 0 || pc.y () >= height)
+    return true;
+  Vr2i dir = bs->getSupportVector ();
+  bool vertical = (abs (dir.x ()) >= abs (dir.y ()));
+  Pt2i p1, p2;
+  if (vertical)
+  {
+    p1.set (pc.x (), pc.y () - hl < 0 ? 0 : pc.y () - hl);
+    p2.set (pc.x (), pc.y () + hl >= height ? height - 1 : pc.y () + hl);
+  }
+  else
+  {
+    p1.set (pc.x () - hl < 0 ? 0 : pc.x () - hl, pc.y ());
+    p2.set (pc.x () + hl >= width ? width - 1 : pc.x () + hl, pc.y ());
+  }
+  if (p1.equals (p2)) return true;
+  vector<Pt2i> pts;
+  p1.draw (pts, p2);
+  int *locmax = new int[pts.size ()];
+  int nlm = gMap->localMax (locmax, pts);
+  int best = -1, bestDist = 0;
+  for (int i = 0; i < nlm; i++)
+  {
+    const Pt2i &pt = pts[locmax[i]];
+    int dist = abs (pt.x () - pc.x ()) + abs (pt.y () - pc.y ());
+    if (gMap->isFree (pt) && (best == -1 || dist < bestDist))
+    {
+      best = locmax[i];
+      bestDist = dist;
+    }
+  }
+  if (best == -1)
+  {
+    delete [] locmax;
+    return true;
+  }
+  Pt2i pCenter = pts[best];
+  delete [] locmax;
+
+  // Fine tracking along the previous support vector
+  bst2->clear ();
+  if (bspre != NULL) delete bspre;
+  bspre = NULL;
+  if (bsini != NULL) delete bsini;
+  bsini = NULL;
+  if (bsf != NULL) delete bsf;
+  bsf = NULL;
+  chArena->reset ();
+  BSPROF_START (profiler, BSProfiler::STAGE_FINE);
+  bsf = bst2->fineTrack (inThick, pCenter, dir, 2 * inThick,
+                         gMap->getValue (pCenter));
+  BSPROF_STOP (profiler, BSProfiler::STAGE_FINE);
+  int res = finalTests (pCenter, dir);
+  BSPROF_RESULT (profiler, res);
+  nbtrials ++;
+  if (res != RESULT_OK) return true;
+  BSPROF_START (profiler, BSProfiler::STAGE_MASK);
+  gMap->setMask (bsf->getPointSpan ());
+  BSPROF_STOP (profiler, BSProfiler::STAGE_MASK);
+  mbsf.push_back (bsf);
+  bsf = NULL; // to avoid BS deletion
+  return ((int) (mbsf.size ()) != maxtrials);
+}
+
+
 int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
                         bool centralp, const Pt2i &pc)
 {
@@ -288,6 +717,7 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
   bsini = NULL;
   if (bsf != NULL) delete bsf;
   bsf = NULL;
+  chArena->reset ();
 
   prep1.set (p1);
   prep2.set (p2);
@@ -298,8 +728,10 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
   //---------------------------------------------------------------------
   if (prelimDetectionOn)
   {
+    BSPROF_START (profiler, BSProfiler::STAGE_PRELIM);
     bspre = bst0->fastTrack (inThick + FAST_TRACK_MARGIN,
                              prep1, prep2, prewidth, prepc);
+    BSPROF_STOP (profiler, BSProfiler::STAGE_PRELIM);
     if (bspre == NULL || bspre->size () < initialMinSize)
       return (bspre == NULL ? RESULT_PRELIM_NO_DETECTION
                             : RESULT_PRELIM_TOO_FEW);
@@ -328,8 +760,10 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
 
   // Initial detection based on highest gradient without orientation constraint
   //---------------------------------------------------------------------------
+  BSPROF_START (profiler, BSProfiler::STAGE_INITIAL);
   bsini = bst1->fastTrack (inThick + FAST_TRACK_MARGIN,
                            inip1, inip2, iniwidth, inipc);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_INITIAL);
   if (bsini == NULL || bsini->size () < initialMinSize)
     return (bsini == NULL ? RESULT_INITIAL_NO_DETECTION
                           : RESULT_INITIAL_TOO_FEW);
@@ -338,6 +772,7 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
   //-------------
   if (initialSparsityTestOn)
   {
+    BSPROF_SCOPE (profiler, BSProfiler::STAGE_SPARSITY);
     DigitalStraightLine mydsl (inip1, inip2, DigitalStraightLine::DSL_NAIVE);
     int mydrlf = mydsl.manhattan (bsini->getLastRight ())
                  - mydsl.manhattan (bsini->getLastLeft ());
@@ -351,6 +786,7 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
   //------------------------------
   if (prefilteringOn)
   {
+    BSPROF_SCOPE (profiler, BSProfiler::STAGE_FILTER);
     BlurredSegment *fbs = lsf1->filter (bsini);
     if (fbs != NULL)
     {
@@ -381,16 +817,25 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
 
   // Finer detection based on gradient maxima with orientation constraint
   //---------------------------------------------------------------------
+  BSPROF_START (profiler, BSProfiler::STAGE_FINE);
   bsf = bst2->fineTrack (inThick, pCenter, bsinidir, 2 * inThick, gRef);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_FINE);
+  return (finalTests (pCenter, bsinidir));
+}
+
+
+int BSDetector::finalTests (const Pt2i &pCenter, const Vr2i &bsinidir)
+{
   if (bsf == NULL || bsf->size () < initialMinSize)
     return (bsf == NULL ? RESULT_FINAL_NO_DETECTION : RESULT_FINAL_TOO_FEW);
+  BSPROF_SCOPE (profiler, BSProfiler::STAGE_FINAL_TESTS);
 
   // Size test
   //------------
   if (finalSizeTestOn)
   {
     // DigitalStraightSegment *dss = bsf->getSegment ();
-    if ((int) (bsf->getAllPoints().size ()) < finalMinSize)
+    if (bsf->size () < finalMinSize)
     {
       // nbSmallBS ++;
       return RESULT_FINAL_TOO_SMALL;
@@ -416,7 +861,7 @@ int BSDetector::detect (const Pt2i &p1, const Pt2i &p2,
   if (finalFragmentationTestOn)
   {
     int bsccp = bsf->countOfConnectedPoints (fragmentMinSize);
-    int bssize = (int) (bsf->getAllPoints().size ());
+    int bssize = bsf->size ();
     if (bsccp < bssize / 2) return RESULT_FINAL_TOO_FRAGMENTED;
   }
 
@@ -455,6 +900,7 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
   bsini = NULL;
   if (bsf != NULL) delete bsf;
   bsf = NULL;
+  chArena->reset ();
 
   inip1.set (p1);
   inip2.set (p2);
@@ -463,8 +909,10 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
 
   // Initial detection based on highest gradient without orientation constraint
   //---------------------------------------------------------------------------
+  BSPROF_START (profiler, BSProfiler::STAGE_INITIAL);
   bsini = bst1->fastTrack (DEFAULT_FAST_TRACK_SCAN_WIDTH / 4,
                            inip1, inip2, iniwidth, inipc);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_INITIAL);
   if (bsini == NULL || bsini->size () < initialMinSize)
     return (bsini == NULL ? RESULT_INITIAL_NO_DETECTION
                           : RESULT_INITIAL_TOO_FEW);
@@ -504,8 +952,10 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
 
   // Finer detection based on gradient maxima with orientation constraint
   //---------------------------------------------------------------------
+  BSPROF_START (profiler, BSProfiler::STAGE_FINE);
   bsf = bstStatic->fineTrack (inThick, pCenter, bsinidir,
                               4 * inThick, gRef);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_FINE);
   if (bsf == NULL || bsf->size () < initialMinSize)
     return (bsf == NULL ? RESULT_FINAL_NO_DETECTION : RESULT_FINAL_TOO_FEW);
 
@@ -517,9 +967,11 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
 
   // Third detection based on gradient maxima with orientation constraint
   //---------------------------------------------------------------------
+  BSPROF_START (profiler, BSProfiler::STAGE_FINE);
   BlurredSegment *bsf2 = bstStatic->fineTrack (inThick,
                                                pCenter, bsf->getSupportVector(),
                                                4 * inThick, gRef);
+  BSPROF_STOP (profiler, BSProfiler::STAGE_FINE);
   if (bsf2 == NULL || bsf2->size () < initialMinSize)
   {
     if (bsf2 != NULL)
@@ -534,13 +986,14 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
     delete bsf;
     bsf = bsf2;
   }
+  BSPROF_SCOPE (profiler, BSProfiler::STAGE_FINAL_TESTS);
 
   // Size test
   //------------
   if (finalSizeTestOn)
   {
     // DigitalStraightSegment *dss = bsf->getSegment ();
-    if ((int) (bsf->getAllPoints().size ()) < finalMinSize)
+    if (bsf->size () < finalMinSize)
     {
       // nbSmallBS ++;
       return RESULT_FINAL_TOO_SMALL;
@@ -566,7 +1019,7 @@ int BSDetector::staticDetect (const Pt2i &p1, const Pt2i &p2,
   if (finalFragmentationTestOn)
   {
     int bsccp = bsf->countOfConnectedPoints (fragmentMinSize);
-    int bssize = (int) (bsf->getAllPoints().size ());
+    int bssize = bsf->size ();
     if (bsccp < bssize / 2) return RESULT_FINAL_TOO_FRAGMENTED;
   }
 
@@ -690,6 +1143,8 @@ void BSDetector::switchPreliminary ()
   {
     prelimDetectionOn = true;
     bst0 = new BSTracker ();
+    bst0->setVertexArena (chArena);
+    bst0->setProfiler (profiler);
     bst0->setGradientMap (gMap);
     if (bst1->orthoScansOn ()) bst0->switchOrthoScans ();
   }
@@ -717,6 +1172,8 @@ void BSDetector::setStaticDetector (bool status)
   else if (status && ! staticDetOn)
   {
     bstStatic = new BSTracker ();
+    bstStatic->setVertexArena (chArena);
+    bstStatic->setProfiler (profiler);
     if (gMap) bstStatic->setGradientMap (gMap);
     if (bstStatic->dynamicScansOn ()) bstStatic->toggleDynamicScans ();
     if (bstStatic->isAssignedThicknessControlOn ())
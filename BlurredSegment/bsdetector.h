@@ -3,7 +3,9 @@
 
 #include "bstracker.h"
 #include "bsfilter.h"
+#include "bsprofiler.h"
 #include <iostream>
+#include <atomic>
 
 using namespace std;
 
@@ -84,9 +86,72 @@ public:
   /**
    * \brief Detects all blurred segments in the picture.
    * Parses X direction first, the Y direction.
+   * Strokes are shared between worker threads if parallel mode is set.
    */
   void detectAll ();
 
+  /**
+   * \brief Detects all blurred segments in a region of the picture.
+   * Strokes and their scans are restricted to the region.
+   * Segments of previous automatic detection lying out of the region are
+   *   kept with their occupancy mask. Those crossing it are tracked again
+   *   from their center and support vector with scans on the whole picture,
+   *   so that they are not truncated at the region border.
+   * @param x0 Left column of the region.
+   * @param y0 Lower line of the region.
+   * @param sizex Region width.
+   * @param sizey Region height.
+   */
+  void detectAll (int x0, int y0, int sizex, int sizey);
+
+  /**
+   * \brief Detects all blurred segments in a new frame of a video sequence.
+   * Each long enough segment of previous automatic detection (at least
+   *   TRACKING_MIN_SIZE_RATIO times the final minimal size) is first
+   *   tracked again by fine tracking from its center and support vector,
+   *   without fast track. The strokes of detectAll are then swept for new
+   *   segments, the seeds lying on found segments being skipped through
+   *   the occupancy mask.
+   * Runs detectAll if there is no previous automatic detection.
+   * The gradient map of the new frame should be set before. If it is
+   *   smaller, previous segments centered out of it are not tracked.
+   */
+  void trackAll ();
+
+  /**
+   * \brief Returns whether automatic detections run in parallel mode.
+   */
+  inline bool isParallelDetection () const { return parallelOn; }
+
+  /**
+   * \brief Switches on or off the parallel mode of automatic detections.
+   */
+  inline void switchParallelDetection () { parallelOn = ! parallelOn; }
+
+  /**
+   * \brief Returns the count of threads used in parallel mode.
+   * Returns 0 if the hardware concurrency is used.
+   */
+  inline int getThreadCount () const { return threadCount; }
+
+  /**
+   * \brief Sets the count of threads used in parallel mode.
+   * @param nb Count of threads (0 for the hardware concurrency).
+   */
+  inline void setThreadCount (int nb) { if (nb >= 0) threadCount = nb; }
+
+  /**
+   * \brief Returns the profiler in use (NULL if none).
+   */
+  inline BSProfiler *getProfiler () const { return profiler; }
+
+  /**
+   * \brief Sets the profiler that records detection stages.
+   * Records are only taken when compiled with FBSD_PROFILING defined.
+   * @param prof Profiler (not owned), or NULL for no record.
+   */
+  void setProfiler (BSProfiler *prof);
+
   /**
    * \brief Detects all blurred segments in the picture.
    * Parses simultaneously the X and Y directions.
@@ -436,6 +501,16 @@ public:
   inline void incAssignedThicknessControlDelay (int val) {
     bst2->incAssignedThicknessControlDelay (val); }
 
+  /**
+   * \brief Returns if fine tracking scans get narrowed to the frozen thickness.
+   */
+  inline bool narrowScansOn () const { return bst2->narrowScansOn (); }
+
+  /**
+   * \brief Toggles the narrowing of fine tracking scans.
+   */
+  inline void toggleNarrowScans () { bst2->toggleNarrowScans (); }
+
   /**
    * \brief Returns if one of the filter is activated.
    */
@@ -641,10 +716,20 @@ private :
   static const int DEFAULT_AUTO_SWEEPING_STEP;
   /** Default value for the preliminary stroke half length. */
   static const int PRELIM_MIN_HALF_WIDTH;
+  /** Half length of tracking search strokes (beyond the thickness). */
+  static const int TRACKING_HALF_LENGTH;
+  /** Minimal size ratio of trackAll searched segments to final min size. */
+  static const int TRACKING_MIN_SIZE_RATIO;
+  /** Count of consecutive strokes swept by a worker in parallel mode. */
+  static const int PARALLEL_CHUNK_SIZE;
 
 
   /** Gradient map. */
   VMap *gMap;
+  /** Vertex arena for the convex hulls, reset at each detection. */
+  CHVertexArena *chArena;
+  /** Profiler in use (not owned). */
+  BSProfiler *profiler;
 
   /** Selects points with opposite gradient direction.
    *  Opposite to gradient direction at start point.
@@ -679,12 +764,42 @@ private :
   int maxtrials;
   /** Automatic detection modality. */
   bool autodet;
+  /** Region of the automatic detection : left column. */
+  int roiX;
+  /** Region of the automatic detection : lower line. */
+  int roiY;
+  /** Region of the automatic detection : width. */
+  int roiWidth;
+  /** Region of the automatic detection : height. */
+  int roiHeight;
   /** Stroke sweeping step for the automatic extraction. */
   int autoSweepingStep;
   /** Result of the blurred segment extraction. */
   int resultValue;
   /** Activation status of static detector (IWCIA'09). */
   bool staticDetOn;
+  /** Parallel mode of automatic detections. */
+  bool parallelOn;
+  /** Count of threads in parallel mode (0 for the hardware concurrency). */
+  int threadCount;
+
+  /**
+   * @struct StrokeChunks bsdetector.h
+   * \brief Chunks of consecutive strokes swept by parallel workers.
+   */
+  struct StrokeChunks
+  {
+    /** Index of the first stroke of each chunk. */
+    vector<int> starts;
+    /** Index after the last stroke. */
+    int last;
+    /** Blurred segments detected in each chunk. */
+    vector<vector<BlurredSegment *> > found;
+    /** Stroke index of each segment detected in each chunk. */
+    vector<vector<int> > origins;
+    /** Count of trials on each stroke. */
+    vector<int> trials;
+  };
 
   /** Assigned maximal thickness to the detector. */
   int inThick;
@@ -749,5 +864,92 @@ private :
    * \brief Resets the multi-selection list.
    */
   void freeMultiSelection ();
+
+  /**
+   * \brief Prepares the multi-selection list and the occupancy mask
+   *   for an automatic detection in the current region.
+   * @param crossing Removed segments crossing the region, to be deleted.
+   */
+  void startAutoDetection (vector<BlurredSegment *> &crossing);
+
+  /**
+   * \brief Runs the stroke sweep of an automatic detection
+   *   (sequential or parallel).
+   */
+  void runAutoDetection ();
+
+  /**
+   * \brief Restricts the scans of all the trackers to a rectangle.
+   * @param x0 Left column of the rectangle.
+   * @param y0 Lower line of the rectangle.
+   * @param sizex Rectangle width.
+   * @param sizey Rectangle height.
+   */
+  void setScanArea (int x0, int y0, int sizex, int sizey);
+
+  /**
+   * \brief Detects a segment again from its previous position.
+   * Fine tracking is run along its support vector from the free gradient
+   *   maximum closest to its center, without fast track, then followed
+   *   by the final tests of detect.
+   * Segments whose center is out of the gradient map are skipped.
+   * Returns false if the maximal count of detections is reached.
+   * @param bs Previous segment.
+   * @param hl Half length of the stroke searched for the maximum.
+   */
+  bool runTracking (BlurredSegment *bs, int hl);
+
+  /**
+   * \brief Applies the final tests to the fine tracked segment.
+   * Returns the detection status (RESULT_OK if successfull).
+   * @param pCenter Start point of the fine tracking.
+   * @param bsinidir Direction of the fine tracking.
+   */
+  int finalTests (const Pt2i &pCenter, const Vr2i &bsinidir);
+
+  /**
+   * \brief Lists the end points of the region strokes in detectAll order.
+   * @param strokes Stroke end points, two by two.
+   */
+  void listStrokes (vector<Pt2i> &strokes) const;
+
+  /**
+   * \brief Detects all blurred segments in the picture with worker threads.
+   * Strokes of detectAll are split into chunks of consecutive strokes,
+   *   swept in four stages : even X stroke chunks, odd X stroke chunks,
+   *   even Y stroke chunks and odd Y stroke chunks. In each stage, each
+   *   chunk is swept by a worker detector on its own occupancy mask,
+   *   initialized with the segments of the former stages. Chunk results
+   *   are then merged in stroke order, a segment being kept if all its
+   *   points are still free in the mask. Otherwise it conflicts with a
+   *   segment of another chunk : it is dropped and its stroke is run again
+   *   on the merged mask, as in sequential mode.
+   * The output slightly differs from sequential mode (about 0.3% of the
+   *   segments), as the strokes at the start of a chunk are swept without
+   *   the segments of the neighbouring chunks of the same stage : seeds
+   *   may be tried in another order and segments get other extents.
+   *   Segments never share a point, as in sequential mode.
+   * The result does not depend on the count of threads.
+   */
+  void detectAllInParallel ();
+
+  /**
+   * \brief Creates a worker detector with the same settings.
+   * @param view Gradient map view used by the worker.
+   */
+  BSDetector *createWorker (VMap *view) const;
+
+  /**
+   * \brief Runs multi-detections on chunks of strokes until none is left
+   *   (worker side).
+   * Each chunk starts from the occupancy mask of the base segments.
+   * @param strokes End points of the strokes.
+   * @param base Blurred segments detected in former stages.
+   * @param next Index of the next chunk to process.
+   * @param chunks Chunks of strokes to process and their results.
+   */
+  void sweepStrokes (const vector<Pt2i> &strokes,
+                     const vector<BlurredSegment *> &base,
+                     atomic<int> &next, StrokeChunks &chunks);
 };
 #endif
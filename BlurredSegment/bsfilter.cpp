@@ -27,12 +27,12 @@ BlurredSegment *BSFilter::filter (BlurredSegment *bs)
 {
   leftIn.clear ();
   rightIn.clear ();
-  vector<Pt2i> *pts = bs->getAllLeft ();
-  vector<Pt2i>::iterator it = pts->end ();
-  while (it-- != pts->begin ()) leftIn.push_back (*it);
-  pts = bs->getAllRight ();
-  it = pts->begin ();
-  while (it != pts->end ()) rightIn.push_back (*it++);
+  PtSpan pts = bs->getLeftSpan ();
+  const Pt2i *it = pts.end ();
+  while (it-- != pts.begin ()) leftIn.push_back (*it);
+  pts = bs->getRightSpan ();
+  it = pts.begin ();
+  while (it != pts.end ()) rightIn.push_back (*it++);
 
   int mw = 1;
   AbsRat sw = bs->minimalWidth ();
@@ -0,0 +1,174 @@
+#include "bsprofiler.h"
+#include "bsdetector.h"
+
+
+const int BSProfiler::STAGE_DETECT = 0;
+const int BSProfiler::STAGE_PRELIM = 1;
+const int BSProfiler::STAGE_INITIAL = 2;
+const int BSProfiler::STAGE_SPARSITY = 3;
+const int BSProfiler::STAGE_FILTER = 4;
+const int BSProfiler::STAGE_FINE = 5;
+const int BSProfiler::STAGE_FINAL_TESTS = 6;
+const int BSProfiler::STAGE_SEEDS = 7;
+const int BSProfiler::STAGE_MASK = 8;
+const int BSProfiler::NB_STAGES = 9;
+
+const int BSProfiler::COUNT_STROKES = 0;
+const int BSProfiler::COUNT_SEEDS = 1;
+const int BSProfiler::COUNT_FAST_SCANS = 2;
+const int BSProfiler::COUNT_FINE_SCANS = 3;
+const int BSProfiler::COUNT_SCANNED_PIXELS = 4;
+const int BSProfiler::COUNT_CANDIDATES = 5;
+const int BSProfiler::NB_COUNTERS = 6;
+
+
+bool BSProfiler::isCompiledIn ()
+{
+#ifdef FBSD_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+BSProfiler::BSProfiler ()
+{
+  starts.resize (NB_STAGES);
+  reset ();
+}
+
+
+void BSProfiler::reset ()
+{
+  times.assign (NB_STAGES, 0);
+  calls.assign (NB_STAGES, 0);
+  counters.assign (NB_COUNTERS, 0);
+  results.clear ();
+}
+
+
+void BSProfiler::add (const BSProfiler &prof)
+{
+  for (int i = 0; i < NB_STAGES; i++)
+  {
+    times[i] += prof.times[i];
+    calls[i] += prof.calls[i];
+  }
+  for (int i = 0; i < NB_COUNTERS; i++) counters[i] += prof.counters[i];
+  map<int, int>::const_iterator it = prof.results.begin ();
+  while (it != prof.results.end ())
+  {
+    results[it->first] += it->second;
+    it ++;
+  }
+}
+
+
+int BSProfiler::getResultCount (int code) const
+{
+  map<int, int>::const_iterator it = results.find (code);
+  return (it == results.end () ? 0 : it->second);
+}
+
+
+string BSProfiler::stageName (int stage)
+{
+  if (stage == STAGE_DETECT) return "detect";
+  if (stage == STAGE_PRELIM) return "prelim_fast_track";
+  if (stage == STAGE_INITIAL) return "initial_fast_track";
+  if (stage == STAGE_SPARSITY) return "initial_sparsity_test";
+  if (stage == STAGE_FILTER) return "initial_filtering";
+  if (stage == STAGE_FINE) return "fine_track";
+  if (stage == STAGE_FINAL_TESTS) return "final_tests";
+  if (stage == STAGE_SEEDS) return "seed_search";
+  if (stage == STAGE_MASK) return "mask_update";
+  return "unknown";
+}
+
+
+string BSProfiler::counterName (int counter)
+{
+  if (counter == COUNT_STROKES) return "strokes";
+  if (counter == COUNT_SEEDS) return "seeds";
+  if (counter == COUNT_FAST_SCANS) return "fast_track_scans";
+  if (counter == COUNT_FINE_SCANS) return "fine_track_scans";
+  if (counter == COUNT_SCANNED_PIXELS) return "scanned_pixels";
+  if (counter == COUNT_CANDIDATES) return "fine_track_candidates";
+  return "unknown";
+}
+
+
+string BSProfiler::resultName (int code)
+{
+  if (code == BSDetector::RESULT_VOID) return "RESULT_VOID";
+  if (code == BSDetector::RESULT_UNDETERMINED) return "RESULT_UNDETERMINED";
+  if (code == BSDetector::RESULT_OK) return "RESULT_OK";
+  if (code == BSDetector::RESULT_PRELIM_NO_DETECTION)
+    return "RESULT_PRELIM_NO_DETECTION";
+  if (code == BSDetector::RESULT_PRELIM_TOO_FEW)
+    return "RESULT_PRELIM_TOO_FEW";
+  if (code == BSDetector::RESULT_INITIAL_NO_DETECTION)
+    return "RESULT_INITIAL_NO_DETECTION";
+  if (code == BSDetector::RESULT_INITIAL_TOO_FEW)
+    return "RESULT_INITIAL_TOO_FEW";
+  if (code == BSDetector::RESULT_INITIAL_TOO_SPARSE)
+    return "RESULT_INITIAL_TOO_SPARSE";
+  if (code == BSDetector::RESULT_INITIAL_TOO_MANY_OUTLIERS)
+    return "RESULT_INITIAL_TOO_MANY_OUTLIERS";
+  if (code == BSDetector::RESULT_INITIAL_CLOSE_ORIENTATION)
+    return "RESULT_INITIAL_CLOSE_ORIENTATION";
+  if (code == BSDetector::RESULT_FINAL_NO_DETECTION)
+    return "RESULT_FINAL_NO_DETECTION";
+  if (code == BSDetector::RESULT_FINAL_TOO_FEW)
+    return "RESULT_FINAL_TOO_FEW";
+  if (code == BSDetector::RESULT_FINAL_TOO_SPARSE)
+    return "RESULT_FINAL_TOO_SPARSE";
+  if (code == BSDetector::RESULT_FINAL_TOO_SMALL)
+    return "RESULT_FINAL_TOO_SMALL";
+  if (code == BSDetector::RESULT_FINAL_TOO_FRAGMENTED)
+    return "RESULT_FINAL_TOO_FRAGMENTED";
+  if (code == BSDetector::RESULT_FINAL_TOO_MANY_OUTLIERS)
+    return "RESULT_FINAL_TOO_MANY_OUTLIERS";
+  return "RESULT_UNKNOWN";
+}
+
+
+void BSProfiler::writeJSON (ostream &out) const
+{
+  out << "{" << endl << "  \"stages\": {" << endl;
+  for (int i = 0; i < NB_STAGES; i++)
+    out << "    \"" << stageName (i) << "\": { \"calls\": " << calls[i]
+        << ", \"time_ms\": " << getTime (i) << " }"
+        << (i == NB_STAGES - 1 ? "" : ",") << endl;
+  out << "  }," << endl << "  \"counters\": {" << endl;
+  for (int i = 0; i < NB_COUNTERS; i++)
+    out << "    \"" << counterName (i) << "\": " << counters[i]
+        << (i == NB_COUNTERS - 1 ? "" : ",") << endl;
+  out << "  }," << endl << "  \"results\": {" << endl;
+  map<int, int>::const_iterator it = results.begin ();
+  while (it != results.end ())
+  {
+    out << "    \"" << resultName (it->first) << "\": " << it->second;
+    if (++it != results.end ()) out << ",";
+    out << endl;
+  }
+  out << "  }" << endl << "}" << endl;
+}
+
+
+void BSProfiler::writeCSV (ostream &out) const
+{
+  out << "kind,name,calls,value" << endl;
+  for (int i = 0; i < NB_STAGES; i++)
+    out << "stage," << stageName (i) << "," << calls[i] << ","
+        << getTime (i) << endl;
+  for (int i = 0; i < NB_COUNTERS; i++)
+    out << "counter," << counterName (i) << ",," << counters[i] << endl;
+  map<int, int>::const_iterator it = results.begin ();
+  while (it != results.end ())
+  {
+    out << "result," << resultName (it->first) << ",," << it->second << endl;
+    it ++;
+  }
+}
@@ -0,0 +1,226 @@
+#ifndef BS_PROFILER_H
+#define BS_PROFILER_H
+
+#include <cstdlib>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+
+/**
+ * @class BSProfiler bsprofiler.h
+ * \brief Per-stage timing and counters of blurred segment detections.
+ * Records are only taken when the code is compiled with FBSD_PROFILING
+ *   defined : otherwise the instrumentation macros below expand to nothing
+ *   and a profiler attached to a detector stays empty.
+ * Stage times are wall times summed over all the calls (in parallel
+ *   detection, over all the worker threads).
+ * \author {P. Even}
+ */
+class BSProfiler
+{
+public:
+
+  /** Stage : whole detection from a seed (detect or staticDetect). */
+  static const int STAGE_DETECT;
+  /** Stage : preliminary fast track. */
+  static const int STAGE_PRELIM;
+  /** Stage : initial fast track. */
+  static const int STAGE_INITIAL;
+  /** Stage : initial sparsity test. */
+  static const int STAGE_SPARSITY;
+  /** Stage : initial filtering. */
+  static const int STAGE_FILTER;
+  /** Stage : fine track. */
+  static const int STAGE_FINE;
+  /** Stage : final tests and filtering. */
+  static const int STAGE_FINAL_TESTS;
+  /** Stage : seed search on a stroke. */
+  static const int STAGE_SEEDS;
+  /** Stage : occupancy mask update. */
+  static const int STAGE_MASK;
+  /** Number of stages. */
+  static const int NB_STAGES;
+
+  /** Counter : processed strokes. */
+  static const int COUNT_STROKES;
+  /** Counter : seeds found on the strokes. */
+  static const int COUNT_SEEDS;
+  /** Counter : scans of fast tracks. */
+  static const int COUNT_FAST_SCANS;
+  /** Counter : scans of fine tracks. */
+  static const int COUNT_FINE_SCANS;
+  /** Counter : scanned pixels. */
+  static const int COUNT_SCANNED_PIXELS;
+  /** Counter : candidates (local maxima) proposed to fine tracks. */
+  static const int COUNT_CANDIDATES;
+  /** Number of counters. */
+  static const int NB_COUNTERS;
+
+
+  /**
+   * @class Scope bsprofiler.h
+   * \brief Times a stage until the end of the enclosing block.
+   */
+  class Scope
+  {
+  public:
+    /** Starts timing a stage (if the profiler is set). */
+    Scope (BSProfiler *prof, int stage) : prof (prof), stage (stage) {
+      if (prof != NULL) prof->start (stage); }
+    /** Stops timing the stage. */
+    ~Scope () { if (prof != NULL) prof->stop (stage); }
+  private:
+    /** Profiler in use. */
+    BSProfiler *prof;
+    /** Timed stage. */
+    int stage;
+  };
+
+
+  /**
+   * \brief Returns whether the instrumentation is compiled in.
+   */
+  static bool isCompiledIn ();
+
+  /**
+   * \brief Creates an empty profiler.
+   */
+  BSProfiler ();
+
+  /**
+   * \brief Clears all the records.
+   */
+  void reset ();
+
+  /**
+   * \brief Starts timing a stage.
+   * @param stage Stage identifier.
+   */
+  inline void start (int stage) {
+    starts[stage] = chrono::steady_clock::now (); }
+
+  /**
+   * \brief Stops timing a stage and counts the call.
+   * @param stage Stage identifier.
+   */
+  inline void stop (int stage) {
+    times[stage] += chrono::duration_cast<chrono::nanoseconds> (
+                      chrono::steady_clock::now () - starts[stage]).count ();
+    calls[stage] ++; }
+
+  /**
+   * \brief Increments a counter.
+   * @param counter Counter identifier.
+   * @param n Increment value.
+   */
+  inline void count (int counter, int n) { counters[counter] += n; }
+
+  /**
+   * \brief Counts a detection result.
+   * @param code Detection result (see BSDetector RESULT values).
+   */
+  inline void result (int code) { results[code] ++; }
+
+  /**
+   * \brief Adds the records of another profiler.
+   * @param prof Added profiler.
+   */
+  void add (const BSProfiler &prof);
+
+  /**
+   * \brief Returns the total time spent in a stage in milliseconds.
+   * @param stage Stage identifier.
+   */
+  inline double getTime (int stage) const { return (times[stage] * 1.0e-6); }
+
+  /**
+   * \brief Returns the count of calls of a stage.
+   * @param stage Stage identifier.
+   */
+  inline long long getCallCount (int stage) const { return calls[stage]; }
+
+  /**
+   * \brief Returns the value of a counter.
+   * @param counter Counter identifier.
+   */
+  inline long long getCount (int counter) const { return counters[counter]; }
+
+  /**
+   * \brief Returns the count of detections that ended with given result.
+   * @param code Detection result.
+   */
+  int getResultCount (int code) const;
+
+  /**
+   * \brief Returns the name of a stage.
+   * @param stage Stage identifier.
+   */
+  static string stageName (int stage);
+
+  /**
+   * \brief Returns the name of a counter.
+   * @param counter Counter identifier.
+   */
+  static string counterName (int counter);
+
+  /**
+   * \brief Returns the name of a detection result.
+   * @param code Detection result.
+   */
+  static string resultName (int code);
+
+  /**
+   * \brief Writes the records as a JSON object.
+   * @param out Output stream.
+   */
+  void writeJSON (ostream &out) const;
+
+  /**
+   * \brief Writes the records as CSV lines (kind, name, calls, value).
+   * Stage values are times in milliseconds, counter and result values
+   *   are counts.
+   * @param out Output stream.
+   */
+  void writeCSV (ostream &out) const;
+
+
+private:
+
+  /** Start time of each stage. */
+  vector<chrono::steady_clock::time_point> starts;
+  /** Total time of each stage in nanoseconds. */
+  vector<long long> times;
+  /** Count of calls of each stage. */
+  vector<long long> calls;
+  /** Counter values. */
+  vector<long long> counters;
+  /** Count of detections for each result. */
+  map<int, int> results;
+};
+
+
+#ifdef FBSD_PROFILING
+#define BSPROF_START(prof, stage) \
+  do { if ((prof) != NULL) (prof)->start (stage); } while (0)
+#define BSPROF_STOP(prof, stage) \
+  do { if ((prof) != NULL) (prof)->stop (stage); } while (0)
+#define BSPROF_SCOPE(prof, stage) \
+  BSProfiler::Scope bsprofScope ((prof), (stage))
+#define BSPROF_COUNT(prof, counter, n) \
+  do { if ((prof) != NULL) (prof)->count ((counter), (n)); } while (0)
+#define BSPROF_RESULT(prof, code) \
+  do { if ((prof) != NULL) (prof)->result (code); } while (0)
+#else
+#define BSPROF_START(prof, stage) do { } while (0)
+#define BSPROF_STOP(prof, stage) do { } while (0)
+#define BSPROF_SCOPE(prof, stage) do { } while (0)
+#define BSPROF_COUNT(prof, counter, n) do { } while (0)
+#define BSPROF_RESULT(prof, code) do { } while (0)
+#endif
+
+#endif
@@ -10,6 +10,7 @@ const int BSTracker::DEFAULT_MAX_SCAN = 32;
 const int BSTracker::DEFAULT_FITTING_DELAY = 20;
 
 const int BSTracker::DEFAULT_ASSIGNED_THICKNESS_CONTROL_DELAY = 20;
+const int BSTracker::NARROW_SCAN_MARGIN = 2;
 
 const int BSTracker::FAILURE_NO_START = 1;
 const int BSTracker::FAILURE_IMAGE_BOUND_ON_RIGHT = 2;
@@ -33,14 +34,19 @@ BSTracker::BSTracker ()
 
   assignedThicknessControlOn = true;
   assignedThicknessControlDelay = DEFAULT_ASSIGNED_THICKNESS_CONTROL_DELAY;
+  narrowScans = false;
 
   gMap = NULL;
+  vertexArena = NULL;
+  profiler = NULL;
 
   maxScan = DEFAULT_MAX_SCAN;
+  scanp.setPooling (true);
 
   fail = 0;
 
   cand = new int[1]; // to avoid systematic tests
+  scan = new int[1];
   lscan = 0;
   rscan = 0;
 }
@@ -49,6 +55,7 @@ BSTracker::BSTracker ()
 BSTracker::~BSTracker ()
 {
   delete cand;
+  delete [] scan;
 }
 
 
@@ -66,6 +73,26 @@ void BSTracker::setGradientMap (VMap *data)
   scanp.setSize (gMap->getWidth (), gMap->getHeight ());
   delete cand;
   cand = new int[data->getHeightWidthMax ()];
+  delete [] scan;
+  scan = new int[data->getHeightWidthMax ()];
+}
+
+
+void BSTracker::copySettings (const BSTracker *model)
+{
+  proxTestOff = model->proxTestOff;
+  proxThreshold = model->proxThreshold;
+  acceptedLacks = model->acceptedLacks;
+  minRestart = model->minRestart;
+  dynamicScans = model->dynamicScans;
+  fittingDelay = model->fittingDelay;
+  trackCrosswise = model->trackCrosswise;
+  assignedThicknessControlOn = model->assignedThicknessControlOn;
+  assignedThicknessControlDelay = model->assignedThicknessControlDelay;
+  narrowScans = model->narrowScans;
+  maxScan = model->maxScan;
+  orthoScan = model->orthoScan;
+  scanp.setOrtho (orthoScan);
 }
 
 
@@ -84,34 +111,32 @@ BlurredSegment *BSTracker::fastTrack (int bsMaxWidth,
   if (ds == NULL) return NULL;
 
   // Builds a BS builder around a central point
-  vector<Pt2i> pix;
-  if (ds->first (pix) < MIN_SCAN)
+  int nbp = ds->first (scan);
+  if (nbp < MIN_SCAN)
   {
-    delete ds;
+    scanp.release (ds);
     return NULL;
   }
 
-  if (recordScans)
-  {
-    scanBound1.push_back (pix.front ());
-    scanBound2.push_back (pix.back ());
-    scanLine.push_back (pix);
-  }
+  if (recordScans) recordScan (nbp);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_FAST_SCANS, 1);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
   int candide;
+  Pt2i pcand;
   Pt2i pfirst;
   if (swidth != 0) pfirst.set (pc.x (), pc.y ());
   else
   {
-    candide = gMap->largestIn (pix);
+    candide = gMap->largestIn (scan, nbp);
     if (candide == -1)
     {
-      delete ds;
+      scanp.release (ds);
       return NULL;
     }
-    pfirst.set (pix.at (candide));
+    pfirst.set (gMap->pointAt (scan[candide]));
   }
 
-  BlurredSegmentProto bs (bsMaxWidth, pfirst);
+  BlurredSegmentProto bs (bsMaxWidth, pfirst, vertexArena);
   Pt2i lastLeft (pfirst);
   Pt2i lastRight (pfirst);
   
@@ -128,26 +153,24 @@ BlurredSegment *BSTracker::fastTrack (int bsMaxWidth,
     // Extends on right
     if (scanningRight)
     {
-      if (ds->nextOnRight (pix) < MIN_SCAN) scanningRight = false;
+      nbp = ds->nextOnRight (scan);
+      if (nbp < MIN_SCAN) scanningRight = false;
       else
       {
-        if (recordScans)
-        {
-          scanBound1.push_back (pix.front ());
-          scanBound2.push_back (pix.back ());
-          scanLine.push_back (pix);
-        }
+        if (recordScans) recordScan (nbp);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_FAST_SCANS, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
         added = false;
-        candide = gMap->largestIn (pix);
+        candide = gMap->largestIn (scan, nbp);
         if (candide != -1)
         {
-          if (proxTestOff
-              || lastRight.manhattan (pix.at (candide)) <= proxThreshold)
-            added = bs.addRight (pix.at (candide));
+          pcand = gMap->pointAt (scan[candide]);
+          if (proxTestOff || lastRight.manhattan (pcand) <= proxThreshold)
+            added = bs.addRight (pcand);
         }
         if (added)
         {
-          lastRight = pix.at (candide);
+          lastRight = pcand;
           if (rstop != 0) rstop = 0;
         }
         else if (++rstop > acceptedLacks)
@@ -157,26 +180,24 @@ BlurredSegment *BSTracker::fastTrack (int bsMaxWidth,
     // Extends on left
     if (scanningLeft)
     {
-      if (ds->nextOnLeft (pix) < MIN_SCAN) scanningLeft = false;
+      nbp = ds->nextOnLeft (scan);
+      if (nbp < MIN_SCAN) scanningLeft = false;
       else
       {
-        if (recordScans)
-        {
-          scanBound1.push_back (pix.front ());
-          scanBound2.push_back (pix.back ());
-          scanLine.push_back (pix);
-        }
+        if (recordScans) recordScan (nbp);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_FAST_SCANS, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
         added = false;
-        candide = gMap->largestIn (pix);
+        candide = gMap->largestIn (scan, nbp);
         if (candide != -1)
         {
-          if (proxTestOff
-              || lastLeft.manhattan (pix.at (candide)) <= proxThreshold)
-            added = bs.addLeft (pix.at (candide));
+          pcand = gMap->pointAt (scan[candide]);
+          if (proxTestOff || lastLeft.manhattan (pcand) <= proxThreshold)
+            added = bs.addLeft (pcand);
         }
         if (added)
         {
-          lastLeft = pix.at (candide);
+          lastLeft = pcand;
           if (lstop != 0) lstop = 0;
         }
         else if (++lstop > acceptedLacks)
@@ -184,7 +205,7 @@ BlurredSegment *BSTracker::fastTrack (int bsMaxWidth,
       }
     }
   }
-  delete ds;
+  scanp.release (ds);
   return (bs.endOfBirth ());
 }
 
@@ -213,33 +234,33 @@ BlurredSegment *BSTracker::fineTrack (int bsMaxWidth,
   }
 
   // Looking for a central point
-  vector<Pt2i> pix;
-  if (ds->first (pix) < MIN_SCAN)
+  int nbp = ds->first (scan);
+  if (nbp < MIN_SCAN)
   {
-    delete ds;
+    scanp.release (ds);
     fail = FAILURE_NO_START;
     return NULL;
   }
-  if (recordScans)
-  {
-    scanBound1.push_back (pix.front ());
-    scanBound2.push_back (pix.back ());
-    scanLine.push_back (pix);
-  }
-  int nbc = gMap->localMax (cand, pix, normal);
+  if (recordScans) recordScan (nbp);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_FINE_SCANS, 1);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
+  int nbc = gMap->localMax (cand, scan, nbp, normal, 1);
+  BSPROF_COUNT (profiler, BSProfiler::COUNT_CANDIDATES, nbc);
   if (nbc == 0)
   {
-    delete ds;
+    scanp.release (ds);
     fail = FAILURE_NO_START;
     return NULL;
   }
 
-  BlurredSegmentProto bs (bsMaxWidth, pix[cand[0]]);
+  BlurredSegmentProto bs (bsMaxWidth, gMap->pointAt (scan[cand[0]]),
+                          vertexArena);
 
   // Handles assigned thickness control
   bool atcOn = assignedThicknessControlOn;
   int stableWidthCount = 0;
   int count = 0;
+  int minScan = MIN_SCAN;
 
   // Extends the segment
   lscan = 0;
@@ -263,6 +284,19 @@ BlurredSegment *BSTracker::fineTrack (int bsMaxWidth,
       AbsRat finalWidth (bs.digitalThickness().sumHalf ());
       if (finalWidth.lessThan (bs.getMaxWidth ())) bs.setMaxWidth (finalWidth);
       atcOn = false;
+
+      // Narrows the dynamic scans to the frozen thickness
+      if (narrowScans && dynamicScans)
+      {
+        AbsRat mw (bs.getMaxWidth ());
+        int nw = (mw.num () + mw.den () - 1) / mw.den ()
+                 + 2 * NARROW_SCAN_MARGIN;
+        if (nw < scanwidth)
+        {
+          ds->scaleStripe (nw, scanwidth);
+          if (nw < minScan) minScan = nw;
+        }
+      }
     }
 
     // Resets the scan stripe
@@ -300,23 +334,27 @@ BlurredSegment *BSTracker::fineTrack (int bsMaxWidth,
     if (scanningRight)
     {
       added = false;
-      if (ds->nextOnRight (pix) < MIN_SCAN)
+      nbp = ds->nextOnRight (scan);
+      if (nbp < minScan)
       {
         fail += FAILURE_IMAGE_BOUND_ON_RIGHT;
         scanningRight = false;
       }
       else
       {
-        if (recordScans)
-        {
-          scanBound1.push_back (pix.front ());
-          scanBound2.push_back (pix.back ());
-          scanLine.push_back (pix);
-        }
+        if (recordScans) recordScan (nbp);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_FINE_SCANS, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
         added = false;
-        nbc = gMap->localMax (cand, pix, normal);
+        // Only the first candidate is sorted, next ones on rejection
+        //   (sortNextMax relies on this localMax call being the last one)
+        nbc = gMap->localMax (cand, scan, nbp, normal, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_CANDIDATES, nbc);
         for (int i = 0; ! added && i < nbc; i++)
-          added = bs.addRight (pix[cand[i]]);
+        {
+          if (i != 0) gMap->sortNextMax (cand, i, nbc);
+          added = bs.addRight (gMap->pointAt (scan[cand[i]]));
+        }
         stableWidthCount ++;
         if (added)
         {
@@ -349,23 +387,27 @@ BlurredSegment *BSTracker::fineTrack (int bsMaxWidth,
     // Extends on left
     if (scanningLeft)
     {
-      if (ds->nextOnLeft (pix) < MIN_SCAN)
+      nbp = ds->nextOnLeft (scan);
+      if (nbp < minScan)
       {
         fail += FAILURE_IMAGE_BOUND_ON_LEFT;
         scanningLeft = false;
       }
       else
       {
-        if (recordScans)
-        {
-          scanBound1.push_back (pix.front ());
-          scanBound2.push_back (pix.back ());
-          scanLine.push_back (pix);
-        }
+        if (recordScans) recordScan (nbp);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_FINE_SCANS, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_SCANNED_PIXELS, nbp);
         added = false;
-        nbc = gMap->localMax (cand, pix, normal);
+        // Only the first candidate is sorted, next ones on rejection
+        //   (sortNextMax relies on this localMax call being the last one)
+        nbc = gMap->localMax (cand, scan, nbp, normal, 1);
+        BSPROF_COUNT (profiler, BSProfiler::COUNT_CANDIDATES, nbc);
         for (int i = 0; ! added && i < nbc; i++)
-          added = bs.addLeft (pix[cand[i]]);
+        {
+          if (i != 0) gMap->sortNextMax (cand, i, nbc);
+          added = bs.addLeft (gMap->pointAt (scan[cand[i]]));
+        }
         stableWidthCount ++;
         if (added)
         {
@@ -397,11 +439,21 @@ BlurredSegment *BSTracker::fineTrack (int bsMaxWidth,
   }
   if (rstart) bs.removeRight (rstart);
   if (lstart) bs.removeLeft (lstart);
-  delete ds;
+  scanp.release (ds);
   return (bs.endOfBirth ());
 }
 
 
+void BSTracker::recordScan (int nbp)
+{
+  vector<Pt2i> pix;
+  for (int i = 0; i < nbp; i++) pix.push_back (gMap->pointAt (scan[i]));
+  scanBound1.push_back (pix.front ());
+  scanBound2.push_back (pix.back ());
+  scanLine.push_back (pix);
+}
+
+
 void BSTracker::switchOrthoScans ()
 {
   orthoScan = ! orthoScan;
@@ -5,6 +5,7 @@
 #include "scannerprovider.h"
 #include "blurredsegment.h"
 #include "vmap.h"
+#include "bsprofiler.h"
 
 using namespace std;
 
@@ -107,6 +108,36 @@ public:
    */
   void setGradientMap (VMap *data);
 
+  /**
+   * \brief Restricts the scans to a rectangle of the gradient map.
+   * The whole map is scanned again after next call to setGradientMap.
+   * @param x0 Left column of the rectangle.
+   * @param y0 Lower line of the rectangle.
+   * @param sizex Rectangle width.
+   * @param sizey Rectangle height.
+   */
+  inline void setScanArea (int x0, int y0, int sizex, int sizey) {
+    scanp.setArea (x0, y0, sizex, sizey); }
+
+  /**
+   * \brief Sets the vertex arena used for the convex hulls of built segments.
+   * @param arena Vertex arena, or NULL for individual vertex allocations.
+   */
+  inline void setVertexArena (CHVertexArena *arena) { vertexArena = arena; }
+
+  /**
+   * \brief Sets the profiler that records scan and candidate counts.
+   * @param prof Profiler, or NULL for no record.
+   */
+  inline void setProfiler (BSProfiler *prof) { profiler = prof; }
+
+  /**
+   * \brief Copies the tracking settings of another tracker.
+   * Gradient map and recorded scans are not copied.
+   * @param model Tracker to be imitated.
+   */
+  void copySettings (const BSTracker *model);
+
   /**
    * \brief Returns the proximity test status.
    */
@@ -203,6 +234,18 @@ public:
     assignedThicknessControlDelay += val;
     if (assignedThicknessControlDelay < 1) assignedThicknessControlDelay = 1; }
 
+  /**
+   * \brief Returns if dynamic scans get narrowed by assigned thickness control.
+   */
+  inline bool narrowScansOn () const { return narrowScans; }
+
+  /**
+   * \brief Toggles the narrowing of dynamic scans.
+   * When assigned thickness control freezes the segment thickness, dynamic
+   *   scans are narrowed to this thickness plus a margin on each side.
+   */
+  inline void toggleNarrowScans () { narrowScans = ! narrowScans; }
+
   /**
    * \brief Switches on or off the orthogonal scanning modality.
    */
@@ -231,6 +274,9 @@ private :
   /* Maximal count of points before activating assigned thickness control. */
   static const int DEFAULT_ASSIGNED_THICKNESS_CONTROL_DELAY;
 
+  /** Margin on each side of narrowed dynamic scans. */
+  static const int NARROW_SCAN_MARGIN;
+
   /** Segment stop information : no start point found. */
   static const int FAILURE_NO_START;
   /** Segment stop information : image bound reached on the right. */
@@ -272,6 +318,8 @@ private :
   bool assignedThicknessControlOn;
   /** Count of stable point insertion before activation of ATC. */
   int assignedThicknessControlDelay;
+  /** Narrowing of dynamic scans after assigned thickness control. */
+  bool narrowScans;
 
   /** Gradient map. */
   VMap *gMap;
@@ -284,6 +332,12 @@ private :
 
   /** Candidates array for internal use. */
   int *cand;
+  /** Scanned points array (map indices) for internal use. */
+  int *scan;
+  /** Vertex arena for the convex hulls of built segments. */
+  CHVertexArena *vertexArena;
+  /** Profiler in use (not owned). */
+  BSProfiler *profiler;
   /** Index of the last successful scan on right side. */
   int rscan;
   /** Index of the last successful scan on left side. */
@@ -301,5 +355,12 @@ private :
   vector <vector <Pt2i> > scanLine;
   /** Dynamical scanner record modality. */
   bool recordScans;
+
+
+  /**
+   * \brief Records the last scan line for display purpose.
+   * @param nbp Count of points in the scan line.
+   */
+  void recordScan (int nbp);
 };
 #endif
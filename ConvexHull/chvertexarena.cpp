@@ -0,0 +1,35 @@
+#include "chvertexarena.h"
+
+
+const int CHVertexArena::BLOCK_SIZE = 1024;
+
+
+CHVertexArena::CHVertexArena ()
+{
+  curBlock = 0;
+  curIndex = 0;
+}
+
+
+CHVertexArena::~CHVertexArena ()
+{
+  vector<CHVertex *>::iterator it = blocks.begin ();
+  while (it != blocks.end ()) delete [] (*it++);
+}
+
+
+CHVertex *CHVertexArena::create (const Pt2i &p)
+{
+  if (curIndex == BLOCK_SIZE)
+  {
+    curBlock ++;
+    curIndex = 0;
+  }
+  if (curBlock == (int) (blocks.size ()))
+    blocks.push_back (new CHVertex[BLOCK_SIZE]);
+  CHVertex *v = blocks[curBlock] + curIndex++;
+  v->set (p);
+  v->setLeft (NULL);
+  v->setRight (NULL);
+  return (v);
+}
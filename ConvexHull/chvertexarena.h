@@ -0,0 +1,62 @@
+#ifndef CHVERTEX_ARENA_H
+#define CHVERTEX_ARENA_H
+
+#include "chvertex.h"
+#include <vector>
+
+using namespace std;
+
+
+/** 
+ * @class CHVertexArena chvertexarena.h
+ * \brief Block allocator for convex hull vertices.
+ * Vertices are taken in sequence from blocks that are kept between
+ *   detections. They are all released at once by a reset, that should
+ *   only happen when no convex hull built on the arena is still in use.
+ * \author {P. Even}
+ */
+class CHVertexArena
+{
+public:
+
+  /**
+   * \brief Creates an empty vertex arena.
+   */
+  CHVertexArena ();
+
+  /**
+   * \brief Deletes the vertex arena and all its blocks.
+   */
+  ~CHVertexArena ();
+
+  /**
+   * \brief Returns a new vertex at given position.
+   * @param p Vertex position.
+   */
+  CHVertex *create (const Pt2i &p);
+
+  /**
+   * \brief Releases all the vertices (blocks are kept for further use).
+   */
+  inline void reset () { curBlock = 0; curIndex = 0; }
+
+  /**
+   * \brief Returns the count of allocated blocks.
+   */
+  inline int getBlockCount () const { return ((int) (blocks.size ())); }
+
+
+private:
+
+  /** Count of vertices in a block. */
+  static const int BLOCK_SIZE;
+
+  /** Allocated blocks. */
+  vector<CHVertex *> blocks;
+  /** Index of the block in use. */
+  int curBlock;
+  /** Index of the next free vertex in the block in use. */
+  int curIndex;
+};
+
+#endif
@@ -1,11 +1,13 @@
 #include "convexhull.h"
 
 
-ConvexHull::ConvexHull (const Pt2i &lpt, const Pt2i &cpt, const Pt2i &rpt)
+ConvexHull::ConvexHull (const Pt2i &lpt, const Pt2i &cpt, const Pt2i &rpt,
+                        CHVertexArena *arena)
 {
-  CHVertex *cvert = new CHVertex (cpt);
-  leftVertex = new CHVertex (lpt);
-  rightVertex = new CHVertex (rpt);
+  this->arena = arena;
+  leftVertex = newVertex (lpt);
+  CHVertex *cvert = newVertex (cpt);
+  rightVertex = newVertex (rpt);
   lastToLeft = false;
 
   if (lpt.toLeft (cpt, rpt))
@@ -31,10 +33,6 @@ ConvexHull::ConvexHull (const Pt2i &lpt, const Pt2i &cpt, const Pt2i &rpt)
   apv.setVertical ();
   apv.init (leftVertex, cvert, rightVertex);
 
-  gbg.push_back (leftVertex);
-  gbg.push_back (cvert);
-  gbg.push_back (rightVertex);
-
   old_left = leftVertex;
   old_right = rightVertex;
   old_aph_vertex = aph.vertex ();
@@ -76,12 +74,20 @@ void ConvexHull::restore ()
 }
 
 
+CHVertex *ConvexHull::newVertex (const Pt2i &pt)
+{
+  if (arena != NULL) return (arena->create (pt));
+  CHVertex *v = new CHVertex (pt);
+  gbg.push_back (v);
+  return (v);
+}
+
+
 bool ConvexHull::addPoint (const Pt2i &pix, bool toleft)
 {
   if (inHull (pix, toleft)) return false;
-  CHVertex *pt = new CHVertex (pix);
+  CHVertex *pt = newVertex (pix);
   lastToLeft = toleft;
-  gbg.push_back (pt);
   preserve ();
   insert (pt, toleft);
   aph.update (pt);
@@ -92,9 +98,8 @@ bool ConvexHull::addPoint (const Pt2i &pix, bool toleft)
 
 bool ConvexHull::addPointDS (const Pt2i &pix, bool toleft)
 {
-  CHVertex *pt = new CHVertex (pix);
+  CHVertex *pt = newVertex (pix);
   lastToLeft = toleft;
-  gbg.push_back (pt);
   preserve ();
   insertDS (pt, toleft);
   aph.update (pt);
@@ -107,7 +112,7 @@ bool ConvexHull::moveLastPoint (const Pt2i &pix)
 {
   restore ();
   if (inHull (pix, lastToLeft)) return false;
-  gbg.pop_back ();
+  if (arena == NULL) gbg.pop_back ();
   preserve ();
   addPoint (pix, lastToLeft);
   return true;
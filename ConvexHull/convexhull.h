@@ -4,6 +4,7 @@
 
 #include <vector> 
 #include "antipodal.h"
+#include "chvertexarena.h"
 
 using namespace std;
 
@@ -24,12 +25,14 @@ public:
    * @param lpt : left end of the polyline.
    * @param cpt : center of the polyline.
    * @param rpt : right end of the polyline.
+   * @param arena : vertex arena to use, or NULL for individual allocations.
    */
-  ConvexHull (const Pt2i &lpt, const Pt2i &cpt, const Pt2i &rpt);
+  ConvexHull (const Pt2i &lpt, const Pt2i &cpt, const Pt2i &rpt,
+              CHVertexArena *arena = NULL);
 
   /**
    * \brief Deletes the convex hull.
-   * Removes all the registred vertices.
+   * Removes all the registred vertices (arena vertices are left to it).
    */
   ~ConvexHull ();
 
@@ -150,10 +153,17 @@ protected:
 
   /** Collection of vertices for clearance. */
   vector<CHVertex*> gbg;
+  /** Vertex arena (NULL if vertices are individually allocated). */
+  CHVertexArena *arena;
 
 
 private:
 
+  /**
+   * Creates a new vertex, in the arena if any.
+   */
+  CHVertex *newVertex (const Pt2i &pt);
+
   /**
    * Stores the convexhull features before a modification.
    */
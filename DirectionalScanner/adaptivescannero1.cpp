@@ -113,103 +113,36 @@ AdaptiveScannerO1::AdaptiveScannerO1 (
 }
 
 
-int AdaptiveScannerO1::first (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO1::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-  bool *nst = steps;         // Current step in scan direction (jpts)
-
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, lcx, lcy, steps);
   return ((int) (scan.size ()));
 }
 
 
-int AdaptiveScannerO1::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO1::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   lcx --;
   // Whenever the control line changed
-  while (lcy < ymax - 1 && lcx >= xmin && dla * lcx + dlb * lcy > dlc1)
-  {
-    if (*lst2) lcx --;
-    lcy ++;
-    if (++lst2 >= fs) lst2 = steps;
-  }
-  while (lcy > ymin && lcx < xmax && dla * lcx + dlb * lcy < dlc1)
-  {
-    if (--lst2 < steps) lst2 = steps + nbs - 1;
-    if (*lst2) lcx ++;
-    lcy --;
-  }
+  center<-1, true, true> (lcx, lcy, lst2, dlc1);
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  bool *nst = lst2;
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x --;
-    y ++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x --;
-    y ++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, lcx, lcy, lst2);
   return ((int) (scan.size ()));
 }
 
 
-int AdaptiveScannerO1::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO1::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   rcx ++;
-  while (rcy < ymax - 1 && rcx >= xmin && dla * rcx + dlb * rcy > dlc1)
-  {
-    if (*rst2) rcx --;
-    rcy ++;
-    if (++rst2 >= fs) rst2 = steps;
-  }
-  while (rcy > ymin && rcx < xmax && dla * rcx + dlb * rcy < dlc1)
-  {
-    if (--rst2 < steps) rst2 = steps + nbs - 1;
-    if (*rst2) rcx ++;
-    rcy --;
-  }
+  center<-1, true, true> (rcx, rcy, rst2, dlc1);
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  bool *nst = rst2;
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, rcx, rcy, rst2);
   return ((int) (scan.size ()));
 }
 
@@ -248,3 +181,51 @@ void AdaptiveScannerO1::bindTo (int a, int b, int c)
   dlc1 = c + nu / 2;
   dlc2 = c - nu / 2;
 }
+
+
+void AdaptiveScannerO1::scaleStripe (int num, int den)
+{
+  templ_nu = (templ_nu * num) / den;
+}
+
+
+int AdaptiveScannerO1::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int AdaptiveScannerO1::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int AdaptiveScannerO1::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int AdaptiveScannerO1::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int AdaptiveScannerO1::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int AdaptiveScannerO1::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
@@ -113,103 +113,36 @@ AdaptiveScannerO2::AdaptiveScannerO2 (
 }
 
 
-int AdaptiveScannerO2::first (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO2::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-  bool *nst = steps;         // Current step in scan direction (jpts)
-
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, lcx, lcy, steps);
   return ((int) (scan.size ()));
 }
 
 
-int AdaptiveScannerO2::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO2::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   lcy --;
   // Whenever the control line changed
-  while (lcx > xmin && lcy < ymax && dla * lcx + dlb * lcy > dlc1)
-  {
-    if (*lst2) lcy ++;
-    lcx --;
-    if (++lst2 >= fs) lst2 = steps;
-  }
-  while (lcx < xmax - 1 && lcy >= ymin && dla * lcx + dlb * lcy < dlc1)
-  {
-    if (--lst2 < steps) lst2 = steps + nbs - 1;
-    if (*lst2) lcy --;
-    lcx ++;
-  }
+  center<-1, false, true> (lcx, lcy, lst2, dlc1);
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  bool *nst = lst2;
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, lcx, lcy, lst2);
   return ((int) (scan.size ()));
 }
 
 
-int AdaptiveScannerO2::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int AdaptiveScannerO2::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   rcy ++;
-  while (rcx > xmin && rcy < ymax && dla * rcx + dlb * rcy > dlc1)
-  {
-    if (*rst2) rcy ++;
-    rcx --;
-    if (++rst2 >= fs) rst2 = steps;
-  }
-  while (rcx < xmax - 1 && rcy >= ymin && dla * rcx + dlb * rcy < dlc1)
-  {
-    if (--rst2 < steps) rst2 = steps + nbs - 1;
-    if (*rst2) rcy --;
-    rcx ++;
-  }
+  center<-1, false, true> (rcx, rcy, rst2, dlc1);
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  bool *nst = rst2;
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, rcx, rcy, rst2);
   return ((int) (scan.size ()));
 }
 
@@ -242,3 +175,51 @@ void AdaptiveScannerO2::bindTo (int a, int b, int c)
   dlc1 = c + nu / 2;
   dlc2 = c - nu / 2;
 }
+
+
+void AdaptiveScannerO2::scaleStripe (int num, int den)
+{
+  templ_nu = (templ_nu * num) / den;
+}
+
+
+int AdaptiveScannerO2::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int AdaptiveScannerO2::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int AdaptiveScannerO2::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int AdaptiveScannerO2::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int AdaptiveScannerO2::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int AdaptiveScannerO2::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
@@ -112,6 +112,11 @@ public:
    */
   int nextOnRight (vector<Pt2i> &scan);
 
+  /** Scans as linear indices (see DirectionalScanner). */
+  int first (int *scan);
+  int nextOnLeft (int *scan);
+  int nextOnRight (int *scan);
+
   /**
    * @fn bindTo(int a, int b, int c)
    * \brief Binds the scan stripe to wrap the given digital line.
@@ -122,6 +127,9 @@ public:
    */
   void bindTo (int a, int b, int c);
 
+  /** Scales the stripe width for next binding (see DirectionalScanner). */
+  void scaleStripe (int num, int den);
+
 
 protected :
 
@@ -132,6 +140,14 @@ protected :
 
   /** Shift coefficient of the discrete lower support line */
   int dlc1;
+
+
+private:
+
+  /** Scan computations shared by both outputs (see DirectionalScanner). */
+  template <class Sink> int scanFirst (Sink &scan);
+  template <class Sink> int scanNextOnLeft (Sink &scan);
+  template <class Sink> int scanNextOnRight (Sink &scan);
 };
 
 #endif
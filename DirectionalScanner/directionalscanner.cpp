@@ -5,7 +5,7 @@
 
 DirectionalScanner::~DirectionalScanner ()
 {
-  if (steps != NULL) delete steps;
+  if (ownsteps && steps != NULL) delete steps;
   steps = NULL;
 }
 
@@ -18,6 +18,13 @@ void DirectionalScanner::bindTo (int a, int b, int c)
 }
 
 
+void DirectionalScanner::scaleStripe (int num, int den)
+{
+  (void) num;
+  (void) den;
+}
+
+
 Pt2i DirectionalScanner::locate (const Pt2i & pt) const
 {
   return (Pt2i (pt));
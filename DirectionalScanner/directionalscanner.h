@@ -13,6 +13,9 @@ using namespace std;
  * @class DirectionalScanner directionalscanner.h
  * \brief Incremental directional scanner.
  * This scanner iterately provides parallel scan lines.
+ * Scan lines are provided either as vectors of points, or as linear
+ *   indices in the scan area (row-major order) in a caller-owned array
+ *   that should hold at least as many values as the largest area size.
  * \author {P. Even and B. Kerautret}
  */
 class DirectionalScanner
@@ -49,6 +52,30 @@ public:
    */
   virtual int nextOnRight (vector<Pt2i> &scan) = 0;
 
+  /**
+   * @fn first(int *scan)
+   * \brief Returns the central scan as linear indices.
+   * Fills in the array with the central scan and returns its size.
+   * @param scan array of scan area indices to be filled in.
+   */
+  virtual int first (int *scan) = 0;
+
+  /**
+   * @fn nextOnLeft(int *scan)
+   * \brief Returns the next scan on the left as linear indices.
+   * Fills in the array with the next scan on left and returns its size.
+   * @param scan array of scan area indices to be filled in.
+   */
+  virtual int nextOnLeft (int *scan) = 0;
+
+  /**
+   * @fn nextOnRight(int *scan)
+   * \brief Returns the next scan on the right as linear indices.
+   * Fills in the array with the next scan on right and returns its size.
+   * @param scan array of scan area indices to be filled in.
+   */
+  virtual int nextOnRight (int *scan) = 0;
+
   /**
    * @fn bindTo(int a, int b, int c)
    * \brief Binds the scan stripe to wrap the given digital line.
@@ -59,6 +86,15 @@ public:
    */
   virtual void bindTo (int a, int b, int c);
 
+  /**
+   * @fn scaleStripe(int num, int den)
+   * \brief Scales the width of the scan stripe.
+   * The new width is taken into account at next binding (bindTo).
+   * @param num Scale numerator.
+   * @param den Scale denominator.
+   */
+  virtual void scaleStripe (int num, int den);
+
   /**
    * @fn Pt2i locate (const Pt2i &pt) const
    * \brief Returns the scanner coordinates of the givent point.
@@ -67,12 +103,72 @@ public:
    */
   virtual Pt2i locate (const Pt2i &pt) const;
 
+  /**
+   * @fn releaseSteps()
+   * \brief Leaves the discrete line pattern to the scanner provider.
+   * The pattern is then no more deleted with the scanner.
+   */
+  inline void releaseSteps () { ownsteps = false; }
+
+  /**
+   * @fn setIndexWidth(int width)
+   * \brief Sets the width of the image that linear indices refer to.
+   * Indices are then counted from the image origin, whatever the scan area.
+   * @param width Image width (0 for indices in the scan area).
+   */
+  inline void setIndexWidth (int width) { iwidth = width; }
+
 
 protected:
 
+  /*
+   * Octant scanners compute each scan once, in three private templates
+   *   parameterized by the scan output (PointSink or IndexSink) :
+   *   - scanFirst (Sink &scan) fills in the central scan,
+   *   - scanNextOnLeft (Sink &scan) fills in the next scan on the left,
+   *   - scanNextOnRight (Sink &scan) fills in the next scan on the right.
+   * Each returns the scan size. The public first, nextOnLeft and nextOnRight
+   *   methods only wrap their output in a sink and call these templates.
+   */
+
+  /**
+   * @class PointSink directionalscanner.h
+   * \brief Scan output to a vector of points.
+   */
+  class PointSink
+  {
+  public:
+    PointSink (vector<Pt2i> &pts) : pts (pts) { }
+    inline void clear () { pts.clear (); }
+    inline void add (int x, int y) { pts.push_back (Pt2i (x, y)); }
+    inline int size () const { return ((int) pts.size ()); }
+  private:
+    vector<Pt2i> &pts;
+  };
+
+  /**
+   * @class IndexSink directionalscanner.h
+   * \brief Scan output to an array of linear indices in the scan area.
+   */
+  class IndexSink
+  {
+  public:
+    IndexSink (int *ind, int x0, int y0, int w)
+            : ind (ind), n (0), x0 (x0), y0 (y0), w (w) { }
+    inline void clear () { n = 0; }
+    inline void add (int x, int y) { ind[n++] = (y - y0) * w + x - x0; }
+    inline int size () const { return n; }
+  private:
+    int *ind;
+    int n, x0, y0, w;
+  };
+
   /** Scanable area. */
   int xmin, ymin, xmax, ymax;
 
+  /** Width of the image indexed by linear indices (0 for the scan area). */
+  int iwidth;
+
   /** Coefficients of the discrete upper support line. */
   int dla, dlb, dlc2;
 
@@ -82,13 +178,145 @@ protected:
   /** Discrete line pattern and its end. */
   bool *steps, *fs;
 
+  /** Flag indicating whether the discrete line pattern is owned. */
+  bool ownsteps;
+
   /** Start position of a scan for both directions. */
   int ccx, ccy, lcx, lcy, rcx, rcy;
 
   /** Current step in scan direction. */
   bool *lst2, *rst2;
 
-  DirectionalScanner () { }
+  DirectionalScanner () : iwidth (0), ownsteps (true) { }
+
+  /**
+   * @fn indexSink(int *ind)
+   * \brief Returns a scan output to the given array of linear indices.
+   * @param ind array of linear indices.
+   */
+  inline IndexSink indexSink (int *ind) const {
+    return (iwidth == 0 ? IndexSink (ind, xmin, ymin, xmax - xmin)
+                        : IndexSink (ind, 0, 0, iwidth)); }
+
+  /**
+   * @fn center(int &x, int &y, bool *&nst, int c)
+   * \brief Moves a scan start point onto the control line.
+   * Used by adaptive scanners after a scan shift or a new binding.
+   *   Template parameters are those of walk. The start point first moves
+   *   forward along the line pattern while it lies on the outer side of the
+   *   control line, then backward while it lies on the inner side, until
+   *   it meets the scan area border. The distance to the control line is
+   *   tracked by a remainder updated at each move.
+   * @param x Start point abscissa.
+   * @param y Start point ordinate.
+   * @param nst Current step in the line pattern (unused without STEPS).
+   * @param c Control line translation parameter.
+   */
+  template <int SX, bool YMAIN, bool STEPS>
+  inline void center (int &x, int &y, bool *&nst, int c) const
+  {
+    int rem = SX * (dla * x + dlb * y - c);
+    const int xrem = dla, yrem = SX * dlb;
+    while (rem < 0
+           && (YMAIN ? (y < ymax - 1
+                        && (! STEPS || (SX < 0 ? x >= xmin : x < xmax)))
+                     : ((SX < 0 ? x > xmin : x < xmax - 1)
+                        && (! STEPS || y < ymax))))
+    {
+      if (YMAIN)
+      {
+        if (STEPS && *nst) { x += SX; rem += xrem; }
+        y ++;
+        rem += yrem;
+      }
+      else
+      {
+        if (STEPS && *nst) { y ++; rem += yrem; }
+        x += SX;
+        rem += xrem;
+      }
+      if (STEPS && ++nst >= fs) nst = steps;
+    }
+    while (rem > 0
+           && (YMAIN ? (y > ymin
+                        && (! STEPS || (SX < 0 ? x < xmax : x >= xmin)))
+                     : ((SX < 0 ? x < xmax - 1 : x > xmin)
+                        && (! STEPS || y >= ymin))))
+    {
+      if (STEPS && --nst < steps) nst = steps + nbs - 1;
+      if (YMAIN)
+      {
+        if (STEPS && *nst) { x -= SX; rem -= xrem; }
+        y --;
+        rem -= yrem;
+      }
+      else
+      {
+        if (STEPS && *nst) { y --; rem -= yrem; }
+        x -= SX;
+        rem -= xrem;
+      }
+    }
+  }
+
+  /**
+   * @fn walk(Sink &scan, int x, int y, bool *nst)
+   * \brief Fills in a scan from its start point up to the stripe bound.
+   * The kernel is specialized at compile time for each octant :
+   *   SX is the sign of x moves (y always increases), YMAIN is set if y is
+   *   the main axis of the scan, STEPS is set if the other axis follows
+   *   the line pattern (unset for vertical and horizontal scans).
+   * Scan positions outside the scan area are skipped. Without STEPS, only
+   *   the main axis is checked, the other coordinate being constant along
+   *   the scan. The position on the stripe bound is tracked by a remainder
+   *   updated at each move, that is positive or null inside the stripe.
+   * @param scan Scan output.
+   * @param x Start point abscissa.
+   * @param y Start point ordinate.
+   * @param nst Current step in the line pattern (unused without STEPS).
+   */
+  template <int SX, bool YMAIN, bool STEPS, class Sink>
+  inline void walk (Sink &scan, int x, int y, bool *nst) const
+  {
+    int rem = SX * (dlc2 - dla * x - dlb * y);
+    const int xrem = - dla, yrem = - SX * dlb;
+    while (rem >= 0 && (((YMAIN || STEPS) && y < ymin)
+                        || ((! YMAIN || STEPS)
+                            && (SX < 0 ? x >= xmax : x < xmin))))
+    {
+      if (YMAIN)
+      {
+        if (STEPS && *nst) { x += SX; rem += xrem; }
+        y ++;
+        rem += yrem;
+      }
+      else
+      {
+        if (STEPS && *nst) { y ++; rem += yrem; }
+        x += SX;
+        rem += xrem;
+      }
+      if (STEPS && ++nst >= fs) nst = steps;
+    }
+    while (rem >= 0 && (! (YMAIN || STEPS) || y < ymax)
+           && (! (! YMAIN || STEPS) || (SX < 0 ? x >= xmin : x < xmax)))
+    {
+      scan.add (x, y);
+      if (YMAIN)
+      {
+        if (STEPS && *nst) { x += SX; rem += xrem; }
+        y ++;
+        rem += yrem;
+      }
+      else
+      {
+        if (STEPS && *nst) { y ++; rem += yrem; }
+        x += SX;
+        rem += xrem;
+      }
+      if (STEPS && ++nst >= fs) nst = steps;
+    }
+  }
 
   /**
    * @fn DirectionalScanner(int xmini, int ymini, int xmaxi, int ymaxi,
@@ -109,7 +337,7 @@ protected:
   DirectionalScanner (int xmini, int ymini, int xmaxi, int ymaxi,
                       int nb, bool* st, int sx, int sy)
              : xmin (xmini), ymin (ymini), xmax (xmaxi), ymax (ymaxi),
-               nbs (nb), steps (st),
+               iwidth (0), nbs (nb), steps (st), ownsteps (true),
                ccx (sx), ccy (sy), lcx (sx), lcy (sy), rcx (sx), rcy (sy) { }
 };
 
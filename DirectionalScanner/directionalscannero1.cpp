@@ -114,29 +114,14 @@ ccy = lcy;
 }
 
 
-int DirectionalScannerO1::first (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO1::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-  bool *nst = steps;         // Current step in scan direction (jpts)
-
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, lcx, lcy, steps);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO1::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO1::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -164,27 +149,12 @@ int DirectionalScannerO1::nextOnLeft (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  bool *nst = lst2;
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, lcx, lcy, lst2);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO1::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO1::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -210,22 +180,7 @@ int DirectionalScannerO1::nextOnRight (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  bool *nst = rst2;
-  while ((x >= xmax || y < ymin) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) x--;
-    y++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, true, true> (scan, rcx, rcy, rst2);
   return ((int) (scan.size ()));
 }
 
@@ -323,3 +278,45 @@ Pt2i DirectionalScannerO1::locate (const Pt2i &pt) const
 
   return (Pt2i (cx, pt.y () - y));
 }
+
+
+int DirectionalScannerO1::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO1::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO1::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int DirectionalScannerO1::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO1::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO1::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
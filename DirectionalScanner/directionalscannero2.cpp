@@ -114,29 +114,14 @@ ccy = lcy;
 }
 
 
-int DirectionalScannerO2::first (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO2::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-  bool *nst = steps;         // Current step in scan direction (jpts)
-
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, lcx, lcy, steps);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO2::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO2::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -162,27 +147,12 @@ int DirectionalScannerO2::nextOnLeft (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  bool *nst = lst2;
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, lcx, lcy, lst2);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO2::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO2::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -209,22 +179,7 @@ int DirectionalScannerO2::nextOnRight (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  bool *nst = rst2;
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x--;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<-1, false, true> (scan, rcx, rcy, rst2);
   return ((int) (scan.size ()));
 }
 
@@ -321,3 +276,45 @@ Pt2i DirectionalScannerO2::locate (const Pt2i &pt) const
 
   return (Pt2i (cy, x - pt.x ()));
 }
+
+
+int DirectionalScannerO2::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO2::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO2::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int DirectionalScannerO2::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO2::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO2::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
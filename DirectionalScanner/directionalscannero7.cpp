@@ -115,29 +115,14 @@ ccy = lcy;
 
 
 
-int DirectionalScannerO7::first (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO7::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-  bool *nst = steps;         // Current step in scan direction (jpts)
-
-  while ((y < ymin || x < xmin) && dla * x + dlb * y <= dlc2)
-  {
-    if (*nst) y++;
-    x++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<1, false, true> (scan, lcx, lcy, steps);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO7::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO7::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -164,27 +149,12 @@ int DirectionalScannerO7::nextOnLeft (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  bool *nst = lst2;
-  while ((y < ymin || x < xmin) && dla * x + dlb * y <= dlc2)
-  {
-    if (*nst) y++;
-    x++;
-    if (++nst >= fs) nst = steps;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x++;
-    if (++nst >= fs) nst = steps;
-  }
+  walk<1, false, true> (scan, lcx, lcy, lst2);
   return ((int) (scan.size ()));
 }
 
 
-int DirectionalScannerO7::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int DirectionalScannerO7::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -210,22 +180,7 @@ int DirectionalScannerO7::nextOnRight (vector<Pt2i> &scan)
   }
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  bool *nst = rst2;
-  while ((y < ymin || x < xmin) && dla * x + dlb * y <= dlc2)
-  {
-    if (*nst) y++;
-    x++;
-    if (++nst == fs) nst = steps;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    if (*nst) y++;
-    x++;
-    if (++nst == fs) nst = steps;
-  }
+  walk<1, false, true> (scan, rcx, rcy, rst2);
   return ((int) (scan.size ()));
 }
 
@@ -322,3 +277,45 @@ Pt2i DirectionalScannerO7::locate (const Pt2i &pt) const
 
   return (Pt2i (cy, pt.x () - x));
 }
+
+
+int DirectionalScannerO7::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO7::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO7::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int DirectionalScannerO7::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int DirectionalScannerO7::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int DirectionalScannerO7::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
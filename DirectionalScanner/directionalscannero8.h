@@ -111,6 +111,11 @@ public:
    */
   int nextOnRight (vector<Pt2i> &scan);
 
+  /** Scans as linear indices (see DirectionalScanner). */
+  int first (int *scan);
+  int nextOnLeft (int *scan);
+  int nextOnRight (int *scan);
+
   /**
    * @fn Pt2i locate (const Pt2i &pt) const
    * \brief Returns the scanner coordinates of the givent point.
@@ -127,6 +132,11 @@ private:
 
   /** State of the scan */
   bool ltransition, rtransition;
+
+  /** Scan computations shared by both outputs (see DirectionalScanner). */
+  template <class Sink> int scanFirst (Sink &scan);
+  template <class Sink> int scanNextOnLeft (Sink &scan);
+  template <class Sink> int scanNextOnRight (Sink &scan);
 };
 
 #endif
@@ -12,6 +12,47 @@
 
 
 
+ScannerProvider::ScannerProvider ()
+                : isOrtho (false),
+                  xmin (0), ymin (0), xmax (100), ymax (100), iwidth (0),
+                  pooled (false), stbuf (NULL), stsize (0),
+                  dso1 (NULL), dso2 (NULL), dso7 (NULL), dso8 (NULL),
+                  aso1 (NULL), aso2 (NULL), aso7 (NULL), aso8 (NULL),
+                  vho1 (NULL), vho2 (NULL), vho7 (NULL), vho8 (NULL)
+{
+}
+
+
+ScannerProvider::~ScannerProvider ()
+{
+  delete dso1;
+  delete dso2;
+  delete dso7;
+  delete dso8;
+  delete aso1;
+  delete aso2;
+  delete aso7;
+  delete aso8;
+  delete vho1;
+  delete vho2;
+  delete vho7;
+  delete vho8;
+  delete [] stbuf;
+}
+
+
+bool *ScannerProvider::stepsBuffer (int n)
+{
+  if (n > stsize)
+  {
+    delete [] stbuf;
+    stsize = n;
+    stbuf = new bool[n];
+  }
+  return (stbuf);
+}
+
+
 DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
 {
   // Enforces P1 to be lower than P2
@@ -26,7 +67,9 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
 
   // Computes the steps position array
   int nbs = 0;
-  bool *steps = p1.stepsTo (p2, &nbs);
+  bool *steps = (pooled ?
+                 p1.stepsTo (p2, &nbs, stepsBuffer (p1.chessboard (p2))) :
+                 p1.stepsTo (p2, &nbs));
 
   // Equation of the strip support lines : ax + by = c
   int a = p2.x () - p1.x ();
@@ -47,11 +90,11 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
         int repx = (p1.x () + p2.x ()) / 2;    // central scan start
         int repy = p1.y () - (int) ((p1.x () - repx) * (p1.x () - p2.x ())
                                     / (p2.y () - p1.y ()));
-        return (new VHScannerO1 (xmin, ymin, xmax, ymax,
-                                 a, b, c2, nbs, steps, repx, repy));
+        return (provide (vho1, xmin, ymin, xmax, ymax,
+                               a, b, c2, nbs, steps, repx, repy));
       }
-      else return (new DirectionalScannerO1 (xmin, ymin, xmax, ymax,
-                          a, b, c2, nbs, steps, p1.x (), p1.y ()));
+      else return (provide (dso1, xmin, ymin, xmax, ymax,
+                                  a, b, c2, nbs, steps, p1.x (), p1.y ()));
     }
     else
     {
@@ -60,11 +103,11 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
         int repy = (p1.y () + p2.y ()) / 2;    // central scan start
         int repx = p1.x () + (int) ((repy - p1.y ()) * (p2.y () - p1.y ())
                                     / (p1.x () - p2.x ()));
-        return (new VHScannerO2 (xmin, ymin, xmax, ymax,
-                                 a, b, c2, nbs, steps, repx, repy));
+        return (provide (vho2, xmin, ymin, xmax, ymax,
+                               a, b, c2, nbs, steps, repx, repy));
       }
-      else return (new DirectionalScannerO2 (xmin, ymin, xmax, ymax,
-                          a, b, c2, nbs, steps, p1.x (), p1.y ()));
+      else return (provide (dso2, xmin, ymin, xmax, ymax,
+                                  a, b, c2, nbs, steps, p1.x (), p1.y ()));
     }
   else
     if (b > a)
@@ -74,11 +117,11 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
         int repx = (p1.x () + p2.x ()) / 2;    // central scan start
         int repy = p1.y () - (int) ((repx - p1.x ()) * (p2.x () - p1.x ())
                                     / (p2.y () - p1.y ()));
-        return (new VHScannerO8 (xmin, ymin, xmax, ymax,
-                                 a, b, c2, nbs, steps, repx, repy));
+        return (provide (vho8, xmin, ymin, xmax, ymax,
+                               a, b, c2, nbs, steps, repx, repy));
       }
-      else return (new DirectionalScannerO8 (xmin, ymin, xmax, ymax,
-                          a, b, c2, nbs, steps, p1.x (), p1.y ()));
+      else return (provide (dso8, xmin, ymin, xmax, ymax,
+                                  a, b, c2, nbs, steps, p1.x (), p1.y ()));
     }
     else
     {
@@ -87,11 +130,11 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2)
         int repy = (p1.y () + p2.y ()) / 2;    // central scan start
         int repx = p1.x () - (int) ((repy - p1.y ()) * (p2.y () - p1.y ())
                                     / (p2.x () - p1.x ()));
-        return (new VHScannerO7 (xmin, ymin, xmax, ymax,
-                                 a, b, c2, nbs, steps, repx, repy));
+        return (provide (vho7, xmin, ymin, xmax, ymax,
+                               a, b, c2, nbs, steps, repx, repy));
       }
-      else return (new DirectionalScannerO7 (xmin, ymin, xmax, ymax,
-                          a, b, c2, nbs, steps, p1.x (), p1.y ()));
+      else return (provide (dso7, xmin, ymin, xmax, ymax,
+                                  a, b, c2, nbs, steps, p1.x (), p1.y ()));
     }
 }
 
@@ -106,7 +149,9 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2,
     
   // Gets the steps position array
   int nbs = 0;
-  bool *steps = v1.stepsTo (v2, &nbs);
+  bool *steps = (pooled ?
+                 v1.stepsTo (v2, &nbs, stepsBuffer (v1.chessboard (v2))) :
+                 v1.stepsTo (v2, &nbs));
 
   // Equation of the straight line passing through the center : ax - by = mu
   int a = v2.y () - v1.y ();
@@ -124,18 +169,18 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i p1, Pt2i p2,
   // Builds and returns the appropriate scanner
   if (b < 0)
     if (-b > a)
-      return (new DirectionalScannerO1 (xmin, ymin, xmax, ymax,
-                                        a, b, c1, c2, nbs, steps, cx, cy));
+      return (provide (dso1, xmin, ymin, xmax, ymax,
+                             a, b, c1, c2, nbs, steps, cx, cy));
     else
-      return (new DirectionalScannerO2 (xmin, ymin, xmax, ymax,
-                                        a, b, c1, c2, nbs, steps, cx, cy));
+      return (provide (dso2, xmin, ymin, xmax, ymax,
+                             a, b, c1, c2, nbs, steps, cx, cy));
   else
     if (b > a)
-      return (new DirectionalScannerO8 (xmin, ymin, xmax, ymax,
-                                        a, b, c1, c2, nbs, steps, cx, cy));
+      return (provide (dso8, xmin, ymin, xmax, ymax,
+                             a, b, c1, c2, nbs, steps, cx, cy));
     else
-      return (new DirectionalScannerO7 (xmin, ymin, xmax, ymax,
-                                        a, b, c1, c2, nbs, steps, cx, cy));
+      return (provide (dso7, xmin, ymin, xmax, ymax,
+                             a, b, c1, c2, nbs, steps, cx, cy));
 }
 
 
@@ -144,7 +189,9 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i centre, Vr2i normal,
 {
   // Gets the steps position array
   int nbs = 0;
-  bool *steps = normal.steps (&nbs);
+  bool *steps = (pooled ?
+                 normal.steps (&nbs, stepsBuffer (normal.chessboard ())) :
+                 normal.steps (&nbs));
 
   // Orients the direction rightwards
   int a = normal.x ();
@@ -158,22 +205,22 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i centre, Vr2i normal,
   // Builds and returns the appropriate scanner
   if (b < 0)
     if (-b > a)
-      return (new DirectionalScannerO1 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+      return (provide (dso1, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
     else
-      return (new DirectionalScannerO2 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+      return (provide (dso2, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
   else
     if (b > a)
-      return (new DirectionalScannerO8 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+      return (provide (dso8, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
     else
-      return (new DirectionalScannerO7 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+      return (provide (dso7, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
 }
 
 
@@ -182,7 +229,9 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i centre, Vr2i normal,
 {
   // Gets the steps position array
   int nbs = 0;
-  bool *steps = normal.steps (&nbs);
+  bool *steps = (pooled ?
+                 normal.steps (&nbs, stepsBuffer (normal.chessboard ())) :
+                 normal.steps (&nbs));
 
   // Orients the direction rightwards
   int a = normal.x ();
@@ -198,62 +247,50 @@ DirectionalScanner *ScannerProvider::getScanner (Pt2i centre, Vr2i normal,
     if (-b > a)
       return (controlable ?
               (isOrtho ?
-               (DirectionalScanner *)
-               new VHScannerO1 (xmin, ymin, xmax, ymax,
-                                a, b, nbs, steps,
-                                centre.x (), centre.y (), length) :
-               (DirectionalScanner *)
-               new AdaptiveScannerO1 (xmin, ymin, xmax, ymax,
-                                      a, b, nbs, steps,
-                                      centre.x (), centre.y (), length)) :
-              (DirectionalScanner *)
-              new DirectionalScannerO1 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+               provide (vho1, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length) :
+               provide (aso1, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length)) :
+              provide (dso1, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
     else
       return (controlable ?
               (isOrtho ?
-               (DirectionalScanner *)
-               new VHScannerO2 (xmin, ymin, xmax, ymax,
-                                a, b, nbs, steps,
-                                centre.x (), centre.y (), length) :
-               (DirectionalScanner *)
-               new AdaptiveScannerO2 (xmin, ymin, xmax, ymax,
-                                      a, b, nbs, steps,
-                                      centre.x (), centre.y (), length)) :
-              (DirectionalScanner *)
-              new DirectionalScannerO2 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+               provide (vho2, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length) :
+               provide (aso2, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length)) :
+              provide (dso2, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
   else
     if (b > a)
       return (controlable ?
               (isOrtho ?
-               (DirectionalScanner *)
-               new VHScannerO8 (xmin, ymin, xmax, ymax,
-                                a, b, nbs, steps,
-                                centre.x (), centre.y (), length) :
-               (DirectionalScanner *)
-               new AdaptiveScannerO8 (xmin, ymin, xmax, ymax,
-                                      a, b, nbs, steps,
-                                      centre.x (), centre.y (), length)) :
-              (DirectionalScanner *)
-              new DirectionalScannerO8 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+               provide (vho8, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length) :
+               provide (aso8, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length)) :
+              provide (dso8, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
     else
       return (controlable ?
               (isOrtho ?
-               (DirectionalScanner *)
-               new VHScannerO7 (xmin, ymin, xmax, ymax,
-                                a, b, nbs, steps,
-                                centre.x (), centre.y (), length) :
-               (DirectionalScanner *)
-               new AdaptiveScannerO7 (xmin, ymin, xmax, ymax,
-                                      a, b, nbs, steps,
-                                      centre.x (), centre.y (), length)) :
-              (DirectionalScanner *)
-              new DirectionalScannerO7 (xmin, ymin, xmax, ymax,
-                                        a, b, nbs, steps,
-                                        centre.x (), centre.y (), length));
+               provide (vho7, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length) :
+               provide (aso7, xmin, ymin, xmax, ymax,
+                              a, b, nbs, steps,
+                              centre.x (), centre.y (), length)) :
+              provide (dso7, xmin, ymin, xmax, ymax,
+                             a, b, nbs, steps,
+                             centre.x (), centre.y (), length));
 }
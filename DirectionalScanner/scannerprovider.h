@@ -2,10 +2,23 @@
 #define SCANNER_PROVIDER_H
 
 #include <cstdlib>
+#include <new>
 #include "directionalscanner.h"
 
 using namespace std;
 
+class DirectionalScannerO1;
+class DirectionalScannerO2;
+class DirectionalScannerO7;
+class DirectionalScannerO8;
+class AdaptiveScannerO1;
+class AdaptiveScannerO2;
+class AdaptiveScannerO7;
+class AdaptiveScannerO8;
+class VHScannerO1;
+class VHScannerO2;
+class VHScannerO7;
+class VHScannerO8;
 
 
 /** 
@@ -13,6 +26,9 @@ using namespace std;
  * \brief Directional scanner provider.
  * Provides ad-hoc directional scanners in the relevant octant
  *   and according to static or dynamical needs.
+ * In pooled mode, one scanner of each class is kept and re-initialized
+ *   at each request, as well as the discrete line pattern array.
+ *   Only one scanner is then valid at a time.
  * \author {P. Even}
  */
 class ScannerProvider
@@ -23,21 +39,28 @@ public:
    * @fn ScannerProvider()
    * \brief Builds a directional scanner provider.
    */
-  ScannerProvider () : isOrtho (false),
-                       xmin (0), ymin (0), xmax (100), ymax (100) { }
+  ScannerProvider ();
+
+  /**
+   * @fn ~ScannerProvider()
+   * \brief Deletes the directional scanner provider and its pooled scanners.
+   */
+  ~ScannerProvider ();
   
   /**
    * @fn void setSize (int sizex, int sizey)
-   * \brief Sets the scanned area size.
-   * @param sizex Scan area width.
-   * @param sizey Scan area height.
+   * \brief Sets the scanned image size.
+   * The whole image is then scanned.
+   * @param sizex Image width.
+   * @param sizey Image height.
    */
    void setSize (int sizex, int sizey) {
-     xmax = xmin + sizex; ymax = ymin + sizey; }
+     xmin = 0; ymin = 0; xmax = sizex; ymax = sizey; iwidth = sizex; }
 
   /**
    * @fn void setArea (int x0, int y0, int sizex, in sizey)
-   * \brief Sets the scanned area size.
+   * \brief Restricts the scanned area to a rectangle of the image.
+   * Linear indices of the scans still refer to the image set by setSize.
    * @param x0 Left column coordinate of the scan area.
    * @param y0 Lower line coordinate of the scan area.
    * @param sizex Scan area width.
@@ -104,9 +127,41 @@ public:
    */
   inline void setOrtho (bool status) { isOrtho = status; }
 
+  /**
+   * @fn isPooling()
+   * \brief Returns whether provided scanners are pooled.
+   */
+  inline bool isPooling () const { return pooled; }
+
+  /**
+   * @fn setPooling(bool status)
+   * \brief Sets the scanner pooling modality.
+   * Should not be changed while a provided scanner is in use.
+   * @param status new status for the scanner pooling modality.
+   */
+  inline void setPooling (bool status) { pooled = status; }
+
+  /**
+   * @fn release(DirectionalScanner *ds)
+   * \brief Releases a provided scanner when no more used.
+   * The scanner is deleted unless it belongs to the pool.
+   * @param ds released scanner.
+   */
+  inline void release (DirectionalScanner *ds) { if (! pooled) delete ds; }
+
 
 private:
 
+  /**
+   * \brief Forbids copies (pooled scanners and pattern array are owned).
+   */
+  ScannerProvider (const ScannerProvider &) = delete;
+
+  /**
+   * \brief Forbids assignments (pooled scanners and pattern array are owned).
+   */
+  ScannerProvider &operator= (const ScannerProvider &) = delete;
+
   /** Orthogonal scanner modality. */
   bool isOrtho;
 
@@ -118,6 +173,66 @@ private:
   int xmax;
   /** Scan area highest y coordinate. */
   int ymax;
+  /** Width of the image indexed by the scans (0 for the scan area). */
+  int iwidth;
+
+  /** Scanner pooling modality. */
+  bool pooled;
+  /** Pooled discrete line pattern array. */
+  bool *stbuf;
+  /** Size of the pooled discrete line pattern array. */
+  int stsize;
+
+  /** Pooled directional scanners. */
+  DirectionalScannerO1 *dso1;
+  DirectionalScannerO2 *dso2;
+  DirectionalScannerO7 *dso7;
+  DirectionalScannerO8 *dso8;
+  /** Pooled adaptive scanners. */
+  AdaptiveScannerO1 *aso1;
+  AdaptiveScannerO2 *aso2;
+  AdaptiveScannerO7 *aso7;
+  AdaptiveScannerO8 *aso8;
+  /** Pooled orthogonal scanners. */
+  VHScannerO1 *vho1;
+  VHScannerO2 *vho2;
+  VHScannerO7 *vho7;
+  VHScannerO8 *vho8;
+
+
+  /**
+   * @fn stepsBuffer(int n)
+   * \brief Returns the pooled discrete line pattern array with given size.
+   * @param n required size.
+   */
+  bool *stepsBuffer (int n);
+
+  /**
+   * @fn provide(T *&pool, Args... args)
+   * \brief Returns a new scanner, or the pooled one re-initialized.
+   * The pooled scanner is rebuilt in place, without any allocation.
+   * @param pool pooled scanner of the required class.
+   * @param args scanner construction parameters.
+   */
+  template <class T, typename... Args>
+  DirectionalScanner *provide (T *&pool, Args... args)
+  {
+    if (! pooled)
+    {
+      T *nds = new T (args...);
+      nds->setIndexWidth (iwidth);
+      return (nds);
+    }
+    if (pool == NULL) pool = new T (args...);
+    else
+    {
+      pool->~T ();
+      new (pool) T (args...);
+    }
+    pool->releaseSteps ();
+    pool->setIndexWidth (iwidth);
+    return (pool);
+  }
 };
 
 #endif
@@ -109,6 +109,19 @@ public:
    * @param scan vectors of points to be filled in.
    */
   int nextOnRight (vector<Pt2i> &scan);
+
+  /** Scans as linear indices (see DirectionalScanner). */
+  int first (int *scan);
+  int nextOnLeft (int *scan);
+  int nextOnRight (int *scan);
+
+
+private:
+
+  /** Scan computations shared by both outputs (see DirectionalScanner). */
+  template <class Sink> int scanFirst (Sink &scan);
+  template <class Sink> int scanNextOnLeft (Sink &scan);
+  template <class Sink> int scanNextOnRight (Sink &scan);
 };
 
 #endif
@@ -105,24 +105,14 @@ VHScannerO2::VHScannerO2 (int xmin, int ymin, int xmax, int ymax,
 }
 
 
-int VHScannerO2::first (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO2::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-
-  while (x >= xmax && dla * x + dlb * y >= dlc2)
-  {
-    x--;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    x--;
-  }
+  walk<-1, false, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO2::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO2::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -130,58 +120,67 @@ int VHScannerO2::nextOnLeft (vector<Pt2i> &scan)
   if (lcy < ymin) return 0;
 
   // Whenever the control line changed
-  while (lcx > xmin && dla * lcx + dlb * lcy > dlc1)
-  {
-    lcx --;
-  }
-  while (lcx < xmax - 1 && dla * lcx + dlb * lcy < dlc1)
-  {
-    lcx ++;
-  }
+  center<-1, false, false> (lcx, lcy, lst2, dlc1);
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  while (x >= xmax && dla * x + dlb * y >= dlc2)
-  {
-    x--;
-  }
-  while (dla * x + dlb * y >= dlc2 && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    x--;
-  }
+  walk<-1, false, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO2::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO2::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   rcy ++;
   if (rcy >= ymax) return 0;
 
-  while (rcx > xmin && dla * rcx + dlb * rcy > dlc1)
-  {
-    rcx --;
-  }
-  while (rcx < xmax - 1 && dla * rcx + dlb * rcy < dlc1)
-  {
-    rcx ++;
-  }
+  center<-1, false, false> (rcx, rcy, rst2, dlc1);
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  while ((y < ymin || x >= xmax) && dla * x + dlb * y >= dlc2)
-  {
-    x--;
-  }
-  while (dla * x + dlb * y >= dlc2 && y < ymax && x >= xmin)
-  {
-    scan.push_back (Pt2i (x, y));
-    x--;
-  }
+  if (rcy < ymin) return 0;
+  walk<-1, false, false> (scan, rcx, rcy, NULL);
   return ((int) (scan.size ()));
 }
+
+
+int VHScannerO2::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO2::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO2::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int VHScannerO2::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO2::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO2::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
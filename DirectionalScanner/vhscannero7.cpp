@@ -106,56 +106,29 @@ VHScannerO7::VHScannerO7 (int xmin, int ymin, int xmax, int ymax,
 
 
 
-int VHScannerO7::first (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO7::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-
-  while (x < xmin && dla * x + dlb * y <= dlc2)
-  {
-    x++;
-  }
-  while (dla * x + dlb * y <= dlc2 && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    x++;
-  }
+  walk<1, false, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO7::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO7::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   lcy ++;
   if (lcy >= ymax) return 0;
 
-  while (lcx < xmax - 1 && dla * lcx + dlb * lcy < dlc1)
-  {
-    lcx ++;
-  }
-  while (lcx > xmin && dla * lcx + dlb * lcy > dlc1)
-  {
-    lcx --;
-  }
+  center<1, false, false> (lcx, lcy, lst2, dlc1);
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  while (x < xmin && dla * x + dlb * y <= dlc2)
-  {
-    x++;
-  }
-  while (dla * x + dlb * y <= dlc2 && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    x++;
-  }
+  walk<1, false, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO7::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO7::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -163,26 +136,51 @@ int VHScannerO7::nextOnRight (vector<Pt2i> &scan)
   if (rcy < ymin) return 0;
 
   // Whenever the control corridor changed
-  while (rcx < xmax - 1 && dla * rcx + dlb * rcy < dlc1)
-  {
-    rcx ++;
-  }
-  while (rcx > xmin && dla * rcx + dlb * rcy > dlc1)
-  {
-    rcx --;
-  }
+  center<1, false, false> (rcx, rcy, rst2, dlc1);
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  while (x < xmin && dla * x + dlb * y <= dlc2)
-  {
-    x++;
-  }
-  while (dla * x + dlb * y <= dlc2 && x < xmax)
-  {
-    scan.push_back (Pt2i (x, y));
-    x++;
-  }
+  walk<1, false, false> (scan, rcx, rcy, NULL);
   return ((int) (scan.size ()));
 }
+
+
+int VHScannerO7::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO7::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO7::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int VHScannerO7::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO7::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO7::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
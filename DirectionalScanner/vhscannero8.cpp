@@ -106,56 +106,29 @@ VHScannerO8::VHScannerO8 (int xmin, int ymin, int xmax, int ymax,
 
 
 
-int VHScannerO8::first (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO8::scanFirst (Sink &scan)
 {
-  int x = lcx, y = lcy;      // Current position coordinates
-
-  while (y < ymin && dla * x + dlb * y <= dlc2)
-  {
-    y++;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    y++;
-  }
+  walk<1, true, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO8::nextOnLeft (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO8::scanNextOnLeft (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
   lcx --;
   if (lcx < xmin) return 0;
 
-  while (lcy < ymax - 1 && dla * lcx + dlb * lcy < dlc1)
-  {
-    lcy ++;
-  }
-  while (lcy > ymin && dla * lcx + dlb * lcy > dlc1)
-  {
-    lcy --;
-  }
+  center<1, true, false> (lcx, lcy, lst2, dlc1);
 
   // Computes the next scan
-  int x = lcx;
-  int y = lcy;
-  while (y < ymin && dla * x + dlb * y <= dlc2)
-  {
-    y++;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    y++;
-  }
+  walk<1, true, false> (scan, lcx, lcy, NULL);
   return ((int) (scan.size ()));
 }
 
 
-int VHScannerO8::nextOnRight (vector<Pt2i> &scan)
+template <class Sink> int VHScannerO8::scanNextOnRight (Sink &scan)
 {
   // Prepares the next scan
   scan.clear ();
@@ -163,26 +136,51 @@ int VHScannerO8::nextOnRight (vector<Pt2i> &scan)
   if (rcx >= xmax) return 0;
 
   // Whenever the control corridor changed
-  while (rcy < ymax - 1 && dla * rcx + dlb * rcy < dlc1)
-  {
-    rcy ++;
-  }
-  while (rcy > ymin && dla * rcx + dlb * rcy > dlc1)
-  {
-    rcy --;
-  }
+  center<1, true, false> (rcx, rcy, rst2, dlc1);
 
   // Computes the next scan
-  int x = rcx;
-  int y = rcy;
-  while (y < ymin && dla * x + dlb * y <= dlc2)
-  {
-    y++;
-  }
-  while (dla * x + dlb * y <= dlc2 && y < ymax)
-  {
-    scan.push_back (Pt2i (x, y));
-    y++;
-  }
+  walk<1, true, false> (scan, rcx, rcy, NULL);
   return ((int) (scan.size ()));
 }
+
+
+int VHScannerO8::first (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO8::nextOnLeft (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO8::nextOnRight (vector<Pt2i> &scan)
+{
+  PointSink sink (scan);
+  return (scanNextOnRight (sink));
+}
+
+
+int VHScannerO8::first (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanFirst (sink));
+}
+
+
+int VHScannerO8::nextOnLeft (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnLeft (sink));
+}
+
+
+int VHScannerO8::nextOnRight (int *scan)
+{
+  IndexSink sink = indexSink (scan);
+  return (scanNextOnRight (sink));
+}
@@ -3,6 +3,7 @@
 ######################################################################
 
 QT+=widgets
+CONFIG += thread
 TEMPLATE = app
 TARGET = FBSD
 INCLUDEPATH += . \
@@ -11,6 +12,8 @@ INCLUDEPATH += . \
            DirectionalScanner \
            ConvexHull \
            ImageTools
+# Per-stage detection profiling (see BSProfiler)
+# DEFINES += FBSD_PROFILING
 OBJECTS_DIR = obj
 
 # Input
@@ -19,12 +22,14 @@ HEADERS += BlurredSegment/biptlist.h \
            BlurredSegment/blurredsegmentproto.h \
            BlurredSegment/bsdetector.h \
            BlurredSegment/bsfilter.h \
+           BlurredSegment/bsprofiler.h \
            BlurredSegment/bstracker.h \
            BSTools/bsdetectionwidget.h \
            BSTools/bsrandomtester.h \
            BSTools/bswindow.h \
            ConvexHull/antipodal.h \
            ConvexHull/chvertex.h \
+           ConvexHull/chvertexarena.h \
            ConvexHull/convexhull.h \
            DirectionalScanner/adaptivescannero1.h \
            DirectionalScanner/adaptivescannero2.h \
@@ -41,9 +46,13 @@ HEADERS += BlurredSegment/biptlist.h \
            DirectionalScanner/vhscannero7.h \
            DirectionalScanner/vhscannero8.h \
            ImageTools/absrat.h \
+           ImageTools/bitmask.h \
            ImageTools/digitalstraightline.h \
            ImageTools/digitalstraightsegment.h \
+           ImageTools/intervalmask.h \
            ImageTools/pt2i.h \
+           ImageTools/ptspan.h \
+           ImageTools/sobel5x5.h \
            ImageTools/strucel.h \
            ImageTools/vmap.h \
            ImageTools/vr2i.h
@@ -53,12 +62,14 @@ SOURCES += main.cpp \
            BlurredSegment/blurredsegmentproto.cpp \
            BlurredSegment/bsdetector.cpp \
            BlurredSegment/bsfilter.cpp \
+           BlurredSegment/bsprofiler.cpp \
            BlurredSegment/bstracker.cpp \
            BSTools/bsdetectionwidget.cpp \
            BSTools/bsrandomtester.cpp \
            BSTools/bswindow.cpp \
            ConvexHull/antipodal.cpp \
            ConvexHull/chvertex.cpp \
+           ConvexHull/chvertexarena.cpp \
            ConvexHull/convexhull.cpp \
            DirectionalScanner/adaptivescannero1.cpp \
            DirectionalScanner/adaptivescannero2.cpp \
@@ -75,9 +86,12 @@ SOURCES += main.cpp \
            DirectionalScanner/vhscannero7.cpp \
            DirectionalScanner/vhscannero8.cpp \
            ImageTools/absrat.cpp \
+           ImageTools/bitmask.cpp \
            ImageTools/digitalstraightline.cpp \
            ImageTools/digitalstraightsegment.cpp \
+           ImageTools/intervalmask.cpp \
            ImageTools/pt2i.cpp \
+           ImageTools/sobel5x5.cpp \
            ImageTools/strucel.cpp \
            ImageTools/vmap.cpp \
            ImageTools/vr2i.cpp
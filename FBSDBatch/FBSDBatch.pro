@@ -0,0 +1,23 @@
+######################################################################
+# Batch command-line driver, linked with the Qt-free detection library
+# (FBSDLib should be built first)
+######################################################################
+
+QT -= core gui
+CONFIG += thread console
+CONFIG -= qt app_bundle
+TEMPLATE = app
+TARGET = fbsdbatch
+QMAKE_CXXFLAGS += -std=c++11
+INCLUDEPATH += .. \
+           ../FBSDLib \
+           ../BlurredSegment \
+           ../DirectionalScanner \
+           ../ConvexHull \
+           ../ImageTools
+LIBS += -L../FBSDLib -lfbsd
+PRE_TARGETDEPS += ../FBSDLib/libfbsd.a
+OBJECTS_DIR = obj
+
+# Input
+SOURCES += mainBatch.cpp
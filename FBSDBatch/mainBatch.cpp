@@ -0,0 +1,373 @@
+#include "linedetector.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+
+/** Batch settings shared by all the workers. */
+struct BatchSettings
+{
+  /** Output directory for one file per image (unused with combined output). */
+  string outdir;
+  /** Combined output stream (NULL if one file per image). */
+  ostream *combined;
+  /** Mutex on the combined output stream and the console. */
+  mutex *lock;
+  /** Gradient extraction method. */
+  int gtype;
+  /** Assigned thickness (0 for default). */
+  int thickness;
+  /** Minimal segment size (0 for default). */
+  int minsize;
+  /** Multi-thread detection inside each image. */
+  bool parallel;
+  /** Occupancy masks stored as row intervals. */
+  bool intervalMask;
+  /** Fine tracking scans narrowed to the frozen thickness. */
+  bool narrowScans;
+  /** Images processed in sequence as video frames. */
+  bool tracking;
+  /** Merged detection profile (NULL if not required). */
+  BSProfiler *profile;
+};
+
+
+static void usage (const char *prog)
+{
+  cout << "Usage : " << prog << " [options] <manifest | directory>" << endl;
+  cout << "  Detects segments in all the images (binary or ascii PGM)"
+       << " listed in the manifest" << endl;
+  cout << "  (one path per line) or found in the directory." << endl;
+  cout << "  -threads <n> : count of worker threads (default : one per core)"
+       << endl;
+  cout << "  -outdir <dir> : one output file per image (default : .)" << endl;
+  cout << "  -combined <file> : all the segments in one file"
+       << " (- for standard output)" << endl;
+  cout << "  -thickness <val> : assigned thickness" << endl;
+  cout << "  -minsize <val> : minimal segment size" << endl;
+  cout << "  -sobel3x3 : Sobel 3x3 gradient (default is Sobel 5x5)" << endl;
+  cout << "  -parallel : strokes shared between threads inside each image"
+       << endl;
+  cout << "  -intervalmask : occupancy masks stored as row intervals"
+       << " (for large images)" << endl;
+  cout << "  -narrowscans : fine tracking scans narrowed to the segment"
+       << " thickness once it is frozen" << endl;
+  cout << "  -tracking : images processed in name order by one thread as"
+       << " video frames" << endl;
+  cout << "  -profile <file> : detection profile in JSON (or CSV if the"
+       << " file name ends with .csv)" << endl;
+}
+
+
+/** Skips blanks and comments in a PGM header. */
+static void skipPgmBlanks (istream &in)
+{
+  int c = in.peek ();
+  while (c == '#' || c == ' ' || c == '\t' || c == '\n' || c == '\r')
+  {
+    if (c == '#') while (c != '\n' && c != EOF) c = in.get ();
+    else in.get ();
+    c = in.peek ();
+  }
+}
+
+
+/**
+ * Loads a PGM image as top down 8 bit rows.
+ * Returns false if the file could not be read.
+ */
+static bool loadPgm (const string &name, vector<unsigned char> &data,
+                     int &width, int &height)
+{
+  ifstream in (name.c_str (), ios::in | ios::binary);
+  if (! in) return false;
+  char m1 = 0, m2 = 0;
+  in.get (m1);
+  in.get (m2);
+  if (m1 != 'P' || (m2 != '2' && m2 != '5')) return false;
+  int maxval = 0;
+  skipPgmBlanks (in);
+  in >> width;
+  skipPgmBlanks (in);
+  in >> height;
+  skipPgmBlanks (in);
+  in >> maxval;
+  if (! in || width <= 0 || height <= 0 || maxval <= 0 || maxval > 65535)
+    return false;
+  in.get ();
+  data.resize (width * height);
+  int nb = width * height;
+  if (m2 == '5')
+  {
+    if (maxval < 256)
+    {
+      in.read ((char *) (&(data[0])), nb);
+      if (in.gcount () != nb) return false;
+      if (maxval != 255)
+        for (int i = 0; i < nb; i++) data[i] = (data[i] * 255) / maxval;
+    }
+    else
+    {
+      vector<unsigned char> raw (2 * nb);
+      in.read ((char *) (&(raw[0])), 2 * nb);
+      if (in.gcount () != 2 * nb) return false;
+      for (int i = 0; i < nb; i++)
+        data[i] = ((raw[2 * i] * 256 + raw[2 * i + 1]) * 255) / maxval;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < nb; i++)
+    {
+      int val = 0;
+      if (! (in >> val)) return false;
+      data[i] = (val * 255) / maxval;
+    }
+  }
+  return true;
+}
+
+
+/** Returns the file name without directory and extension. */
+static string baseName (const string &path)
+{
+  size_t sep = path.find_last_of ('/');
+  string name = (sep == string::npos ? path : path.substr (sep + 1));
+  size_t dot = name.find_last_of ('.');
+  return (dot == string::npos ? name : name.substr (0, dot));
+}
+
+
+/** Collects the image paths from a manifest file or a directory. */
+static bool collectImages (const string &src, vector<string> &names)
+{
+  struct stat st;
+  if (stat (src.c_str (), &st) != 0) return false;
+  if (S_ISDIR (st.st_mode))
+  {
+    DIR *dir = opendir (src.c_str ());
+    if (dir == NULL) return false;
+    struct dirent *ent;
+    while ((ent = readdir (dir)) != NULL)
+    {
+      string name (ent->d_name);
+      size_t dot = name.find_last_of ('.');
+      if (dot != string::npos)
+      {
+        string ext = name.substr (dot);
+        if (ext == ".pgm" || ext == ".PGM")
+          names.push_back (src + "/" + name);
+      }
+    }
+    closedir (dir);
+  }
+  else
+  {
+    ifstream in (src.c_str (), ios::in);
+    string line;
+    while (getline (in, line))
+    {
+      size_t end = line.find_last_not_of (" \t\r");
+      if (end != string::npos && line[0] != '#')
+        names.push_back (line.substr (0, end + 1));
+    }
+  }
+  return true;
+}
+
+
+/** Writes the segments of an image in FBSD -out format. */
+static void writeSegments (ostream &out,
+                           const vector<LineDetector::Segment> &segs)
+{
+  vector<LineDetector::Segment>::const_iterator it = segs.begin ();
+  while (it != segs.end ())
+  {
+    out << it->x1 << " " << it->y1 << " " << it->x2 << " " << it->y2
+        << " " << it->thickness << endl;
+    it ++;
+  }
+}
+
+
+/** Processes images taken in sequence until the list is exhausted. */
+static void processImages (const vector<string> *names, atomic<int> *next,
+                           const BatchSettings *set, atomic<int> *failures)
+{
+  LineDetector detector;
+  detector.setGradientType (set->gtype);
+  if (set->thickness > 0) detector.setAssignedThickness (set->thickness);
+  if (set->minsize > 0) detector.setFinalSizeMinValue (set->minsize);
+  detector.setParallelDetection (set->parallel);
+  detector.setIntervalMask (set->intervalMask);
+  if (set->narrowScans) detector.getDetector ()->toggleNarrowScans ();
+  detector.setTracking (set->tracking);
+  BSProfiler profile;
+  if (set->profile != NULL) detector.getDetector ()->setProfiler (&profile);
+  vector<unsigned char> data;
+  int width = 0, height = 0;
+
+  int num = (*next)++;
+  while (num < (int) (names->size ()))
+  {
+    const string &name = (*names)[num];
+    if (! loadPgm (name, data, width, height))
+    {
+      (*failures) ++;
+      lock_guard<mutex> guard (*(set->lock));
+      cerr << name << " : unreadable image" << endl;
+    }
+    else
+    {
+      detector.detect (&(data[0]), width, height);
+      if (set->combined != NULL)
+      {
+        ostringstream buf;
+        buf << "# " << name << endl;
+        writeSegments (buf, detector.getSegments ());
+        lock_guard<mutex> guard (*(set->lock));
+        *(set->combined) << buf.str ();
+      }
+      else
+      {
+        string outname = set->outdir + "/" + baseName (name) + ".txt";
+        ofstream outf (outname.c_str (), ios::out);
+        writeSegments (outf, detector.getSegments ());
+        outf.close ();
+        if (! outf)
+        {
+          (*failures) ++;
+          lock_guard<mutex> guard (*(set->lock));
+          cerr << outname << " : write error" << endl;
+        }
+      }
+    }
+    num = (*next)++;
+  }
+  if (set->profile != NULL)
+  {
+    lock_guard<mutex> guard (*(set->lock));
+    set->profile->add (profile);
+  }
+}
+
+
+int main (int argc, char *argv[])
+{
+  int nbth = 0;
+  string source (""), combinedName (""), profileName ("");
+  mutex lock;
+  BatchSettings set;
+  set.outdir = ".";
+  set.combined = NULL;
+  set.lock = &lock;
+  set.gtype = VMap::TYPE_SOBEL_5X5;
+  set.thickness = 0;
+  set.minsize = 0;
+  set.parallel = false;
+  set.intervalMask = false;
+  set.narrowScans = false;
+  set.tracking = false;
+  set.profile = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg (argv[i]);
+    if (arg == "-threads" && i + 1 < argc) nbth = atoi (argv[++i]);
+    else if (arg == "-outdir" && i + 1 < argc) set.outdir = argv[++i];
+    else if (arg == "-combined" && i + 1 < argc) combinedName = argv[++i];
+    else if (arg == "-thickness" && i + 1 < argc)
+      set.thickness = atoi (argv[++i]);
+    else if (arg == "-minsize" && i + 1 < argc)
+      set.minsize = atoi (argv[++i]);
+    else if (arg == "-sobel3x3") set.gtype = VMap::TYPE_SOBEL_3X3;
+    else if (arg == "-parallel") set.parallel = true;
+    else if (arg == "-intervalmask") set.intervalMask = true;
+    else if (arg == "-narrowscans") set.narrowScans = true;
+    else if (arg == "-tracking") set.tracking = true;
+    else if (arg == "-profile" && i + 1 < argc) profileName = argv[++i];
+    else if (arg == "--version")
+    {
+      cout << BSDetector::VERSION << endl;
+      return (EXIT_SUCCESS);
+    }
+    else if (arg.at (0) != '-') source = arg;
+    else
+    {
+      usage (argv[0]);
+      return (EXIT_FAILURE);
+    }
+  }
+  if (source.empty ())
+  {
+    usage (argv[0]);
+    return (EXIT_FAILURE);
+  }
+
+  vector<string> names;
+  if (! collectImages (source, names))
+  {
+    cerr << source << " : no such manifest or directory" << endl;
+    return (EXIT_FAILURE);
+  }
+
+  ofstream combinedFile;
+  if (combinedName == "-") set.combined = &cout;
+  else if (! combinedName.empty ())
+  {
+    combinedFile.open (combinedName.c_str (), ios::out);
+    if (! combinedFile)
+    {
+      cerr << combinedName << " : cannot be opened" << endl;
+      return (EXIT_FAILURE);
+    }
+    set.combined = &combinedFile;
+  }
+  if (set.combined != NULL)
+    *(set.combined) << "# Line detection with format : X1 Y1 X2 Y2 THICKNESS"
+                    << endl;
+
+  BSProfiler profile;
+  if (! profileName.empty ())
+  {
+    if (! BSProfiler::isCompiledIn ())
+      cerr << "Profiling not compiled in (define FBSD_PROFILING)" << endl;
+    set.profile = &profile;
+  }
+
+  if (set.tracking)
+  {
+    sort (names.begin (), names.end ());
+    nbth = 1;
+  }
+  if (nbth <= 0) nbth = (int) (thread::hardware_concurrency ());
+  if (nbth > (int) (names.size ())) nbth = (int) (names.size ());
+  if (nbth < 1) nbth = 1;
+  atomic<int> next (0), failures (0);
+  vector<thread> pool;
+  for (int i = 0; i < nbth; i++)
+    pool.push_back (thread (processImages, &names, &next, &set, &failures));
+  for (int i = 0; i < nbth; i++) pool[i].join ();
+
+  if (combinedFile.is_open ()) combinedFile.close ();
+  if (set.profile != NULL)
+  {
+    ofstream profFile (profileName.c_str (), ios::out);
+    if (profileName.size () > 4
+        && profileName.substr (profileName.size () - 4) == ".csv")
+      profile.writeCSV (profFile);
+    else profile.writeJSON (profFile);
+  }
+  return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,20 @@
+######################################################################
+# Consistency checks of the scanner and local max search kernels,
+# linked with the Qt-free detection library (FBSDLib should be built first)
+######################################################################
+
+QT -= core gui
+CONFIG += console
+CONFIG -= qt app_bundle
+TEMPLATE = app
+TARGET = fbsdcheck
+QMAKE_CXXFLAGS += -std=c++11
+INCLUDEPATH += .. \
+           ../DirectionalScanner \
+           ../ImageTools
+LIBS += -L../FBSDLib -lfbsd
+PRE_TARGETDEPS += ../FBSDLib/libfbsd.a
+OBJECTS_DIR = obj
+
+# Input
+SOURCES += mainCheck.cpp
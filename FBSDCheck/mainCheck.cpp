@@ -0,0 +1,461 @@
+#include "scannerprovider.h"
+#include "vmap.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+
+
+/** Count of random scans submitted to the scan line kernel. */
+static const int NB_WALKS = 400000;
+/** Count of scanners tested. */
+static const int NB_SCANNERS = 4000;
+/** Count of random scans submitted to local max search. */
+static const int NB_SIGNALS = 200000;
+/** Width of the test image of local max search. */
+static const int SIGNAL_WIDTH = 64;
+
+
+/** Random generator state (platform independent sequence). */
+static unsigned int randomState = 5;
+
+/** Returns a pseudo-random value in [0, range[. */
+static int nextRandom (int range)
+{
+  randomState = randomState * 1103515245u + 12345u;
+  return ((int) ((randomState >> 8) % (unsigned int) range));
+}
+
+
+/**
+ * @class WalkProbe mainCheck.cpp
+ * \brief Scanner giving access to the scan line kernel with chosen
+ *   stripe, line pattern and scan area.
+ */
+class WalkProbe : public DirectionalScanner
+{
+public:
+
+  /**
+   * \brief Sets random scan area, stripe bound and line pattern.
+   * The stripe bound is drawn so that each move along the main axis
+   *   gets closer to it, as for the scanners of the octant.
+   * @param sx Sign of x moves.
+   * @param ymain Main axis of the scan (true for y).
+   * @param x Start point abscissa.
+   * @param y Start point ordinate.
+   */
+  void draw (int sx, bool ymain, int x, int y)
+  {
+    xmin = nextRandom (40);
+    ymin = nextRandom (40);
+    xmax = xmin + 1 + nextRandom (120);
+    ymax = ymin + 1 + nextRandom (120);
+    setIndexWidth (nextRandom (2) == 0 ? 0 : 200);
+    dla = nextRandom (21) + (ymain ? 0 : 1);
+    dlb = sx * (nextRandom (21) + (ymain ? 1 : 0));
+    dlc2 = dla * x + dlb * y + sx * nextRandom (400);
+    nbs = 1 + nextRandom (12);
+    for (int i = 0; i < nbs; i++) pattern[i] = (nextRandom (2) == 0);
+    steps = pattern;
+    releaseSteps ();
+    fs = pattern + nbs;
+  }
+
+  /**
+   * \brief Compares the kernel scan with the reference scan, to points
+   *   and to linear indices.
+   * Returns whether they are equal.
+   * @param x Start point abscissa.
+   * @param y Start point ordinate.
+   * @param ind Array of linear indices.
+   */
+  template <int SX, bool YMAIN, bool STEPS>
+  bool check (int x, int y, int *ind)
+  {
+    bool *nst = pattern + nextRandom (nbs);
+    vector<Pt2i> ref, pts;
+    referenceWalk<SX, YMAIN, STEPS> (ref, x, y, nst);
+    PointSink ps (pts);
+    walk<SX, YMAIN, STEPS> (ps, x, y, (STEPS ? nst : NULL));
+    if (pts.size () != ref.size ()) return false;
+    IndexSink is = indexSink (ind);
+    walk<SX, YMAIN, STEPS> (is, x, y, (STEPS ? nst : NULL));
+    if (is.size () != (int) (ref.size ())) return false;
+    for (int i = 0; i < (int) (ref.size ()); i++)
+    {
+      if (! pts[i].equals (ref[i])) return false;
+      int refind = (iwidth == 0 ?
+                    (ref[i].y () - ymin) * (xmax - xmin) + ref[i].x () - xmin
+                    : ref[i].y () * iwidth + ref[i].x ());
+      if (ind[i] != refind) return false;
+    }
+    return true;
+  }
+
+  int first (vector<Pt2i> &) { return 0; }
+  int nextOnLeft (vector<Pt2i> &) { return 0; }
+  int nextOnRight (vector<Pt2i> &) { return 0; }
+  int first (int *) { return 0; }
+  int nextOnLeft (int *) { return 0; }
+  int nextOnRight (int *) { return 0; }
+
+
+private:
+
+  /** Line pattern storage. */
+  bool pattern[12];
+
+  /**
+   * \brief Reference scan : the stripe bound is evaluated at each pixel.
+   * @param pts Scanned points.
+   * @param x Start point abscissa.
+   * @param y Start point ordinate.
+   * @param nst Current step in the line pattern.
+   */
+  template <int SX, bool YMAIN, bool STEPS>
+  void referenceWalk (vector<Pt2i> &pts, int x, int y, bool *nst) const
+  {
+    bool ytest = (YMAIN || STEPS), xtest = (! YMAIN || STEPS);
+    while (inStripe (SX, x, y)
+           && ((ytest && y < ymin)
+               || (xtest && (SX < 0 ? x >= xmax : x < xmin))))
+      move<SX, YMAIN, STEPS> (x, y, nst);
+    while (inStripe (SX, x, y) && (! ytest || y < ymax)
+           && (! xtest || (SX < 0 ? x >= xmin : x < xmax)))
+    {
+      pts.push_back (Pt2i (x, y));
+      move<SX, YMAIN, STEPS> (x, y, nst);
+    }
+  }
+
+  /** Returns whether a point lies on the scan side of the stripe bound. */
+  inline bool inStripe (int sx, int x, int y) const
+  {
+    return (sx < 0 ? dla * x + dlb * y >= dlc2 : dla * x + dlb * y <= dlc2);
+  }
+
+  /** Moves to the next point of the scan. */
+  template <int SX, bool YMAIN, bool STEPS>
+  inline void move (int &x, int &y, bool *&nst) const
+  {
+    if (YMAIN)
+    {
+      if (STEPS && *nst) x += SX;
+      y ++;
+    }
+    else
+    {
+      if (STEPS && *nst) y ++;
+      x += SX;
+    }
+    if (STEPS && ++nst >= fs) nst = steps;
+  }
+};
+
+
+/**
+ * Compares the scan line kernel with the reference scan on random stripes,
+ *   patterns and areas, for all the octants.
+ * Returns the count of failed comparisons.
+ */
+static int checkWalk ()
+{
+  WalkProbe probe;
+  int *ind = new int[200 * 200];
+  int fails = 0;
+  randomState = 5;
+  for (int k = 0; k < NB_WALKS; k++)
+  {
+    int x = nextRandom (200) - 20;
+    int y = nextRandom (200) - 20;
+    probe.draw (k % 2 == 0 ? -1 : 1, (k / 2) % 2 == 0, x, y);
+    bool ok = true;
+    switch (k % 8)
+    {
+      case 0 : ok = probe.check<-1, true, true> (x, y, ind); break;
+      case 1 : ok = probe.check<1, true, true> (x, y, ind); break;
+      case 2 : ok = probe.check<-1, false, true> (x, y, ind); break;
+      case 3 : ok = probe.check<1, false, true> (x, y, ind); break;
+      case 4 : ok = probe.check<-1, true, false> (x, y, ind); break;
+      case 5 : ok = probe.check<1, true, false> (x, y, ind); break;
+      case 6 : ok = probe.check<-1, false, false> (x, y, ind); break;
+      case 7 : ok = probe.check<1, false, false> (x, y, ind); break;
+    }
+    if (! ok) fails ++;
+  }
+  delete [] ind;
+  return (fails);
+}
+
+
+/**
+ * Runs a scanner and returns its scans as image indices.
+ * @param ds Scanner.
+ * @param toIndex Scans to linear indices (otherwise to points).
+ * @param nbl Count of scans on each side.
+ * @param bind Binding line applied after half of the scans (if bound).
+ * @param bound Bound scanner.
+ * @param width Image width.
+ * @param ind Array of linear indices.
+ * @param scans Scans as image indices.
+ */
+static void runScanner (DirectionalScanner *ds, bool toIndex, int nbl,
+                        const int *bind, bool bound, int width, int *ind,
+                        vector<vector<int> > &scans)
+{
+  vector<Pt2i> pts;
+  if (toIndex) ds->setIndexWidth (width);
+  for (int i = -1; i < 2 * nbl; i++)
+  {
+    if (i == nbl && bound) ds->bindTo (bind[0], bind[1], bind[2]);
+    int n = 0;
+    if (i == -1) n = (toIndex ? ds->first (ind) : ds->first (pts));
+    else if (i % 2 == 0)
+      n = (toIndex ? ds->nextOnLeft (ind) : ds->nextOnLeft (pts));
+    else n = (toIndex ? ds->nextOnRight (ind) : ds->nextOnRight (pts));
+    vector<int> scan;
+    for (int j = 0; j < n; j++)
+      scan.push_back (toIndex ? ind[j] : pts[j].y () * width + pts[j].x ());
+    scans.push_back (scan);
+  }
+}
+
+
+/**
+ * Runs all the scanner kinds in all the directions, with random strips,
+ *   areas, pooling and bindings, and checks that scans to points and to
+ *   linear indices match and stay in the scan area.
+ * Returns the count of failed scans.
+ */
+static int checkScanners ()
+{
+  int width = 300, height = 250;
+  int fails = 0;
+  ScannerProvider sp;
+  int *ind = new int[width * height];
+  randomState = 5;
+  for (int k = 0; k < NB_SCANNERS; k++)
+  {
+    int mode = k % 8;
+    sp.setOrtho ((k / 8) % 2 == 1);
+    sp.setPooling ((k / 16) % 2 == 1);
+    int x0 = 0, y0 = 0, x1 = width, y1 = height;
+    if (k % 5 == 0)
+    {
+      x0 = nextRandom (50);
+      y0 = nextRandom (50);
+      x1 = x0 + 150 + nextRandom (100);
+      y1 = y0 + 120 + nextRandom (80);
+    }
+    // Draws in sequence (argument evaluation order is unspecified)
+    int px1 = x0 + nextRandom (x1 - x0);
+    int py1 = y0 + nextRandom (y1 - y0);
+    int px2 = x0 + nextRandom (x1 - x0);
+    int py2 = y0 + nextRandom (y1 - y0);
+    int nx = nextRandom (41) - 20;
+    int ny = nextRandom (41) - 20;
+    if (nx == 0 && ny == 0) nx = 1;
+    Pt2i p1 (px1, py1), p2 (px2, py2);
+    Vr2i nv (nx, ny);
+    int length = 3 + nextRandom (30);
+    int nbl = 5 + nextRandom (40);
+    int bind[3] = { nx, ny, nx * px1 + ny * py1 + nextRandom (5) };
+    if (p1.equals (p2)) continue;
+
+    // Same scanner twice : to points, then to image indices
+    vector<vector<int> > scans[2];
+    for (int s = 0; s < 2; s++)
+    {
+      if (k % 5 == 0) sp.setArea (x0, y0, x1 - x0, y1 - y0);
+      else sp.setSize (width, height);
+      DirectionalScanner *ds = NULL;
+      if (mode < 2) ds = sp.getScanner (p1, p2);
+      else if (mode == 2)
+        ds = sp.getScanner (p1, p2, p1, Pt2i (px1 + nx, py1 + ny));
+      else if (mode == 3) ds = sp.getScanner (p1, nv, length);
+      else ds = sp.getScanner (p1, nv, length, mode >= 6);
+      runScanner (ds, s == 1, nbl, bind, mode >= 6, width, ind, scans[s]);
+      sp.release (ds);
+    }
+    for (int i = 0; i < (int) (scans[0].size ()); i++)
+    {
+      bool ok = (scans[0][i] == scans[1][i]);
+      vector<int>::iterator it = scans[0][i].begin ();
+      while (ok && it != scans[0][i].end ())
+      {
+        int x = *it % width, y = *it / width;
+        ok = (x >= x0 && x < x1 && y >= y0 && y < y1);
+        it ++;
+      }
+      if (! ok) fails ++;
+    }
+  }
+  delete [] ind;
+  return (fails);
+}
+
+
+/**
+ * Reference local max search : centers of plateaus between lower values,
+ *   above the magnitude threshold.
+ */
+static int referenceSearch (int *lmax, int n, const int *in, int threshold)
+{
+  int offset = 0;
+  int count = 0;
+  bool up = true;
+  while (offset < n - 1 && in[offset] == in[0])
+  {
+    if (in[offset] - in[offset + 1] < 0)
+    {
+      up = true;
+      break;
+    }
+    if (in[offset] - in[offset + 1] > 0)
+    {
+      up = false;
+      break;
+    }
+    offset++;
+  }
+  for (int i = offset; i < n - 1; i++)
+  {
+    if (up)
+    {
+      if ((in[i + 1] - in[i]) < 0)
+      {
+        up = false;
+        int k = i;
+        while (in[k - 1] == in[i]) k--;
+        if (in[k + (i - k) / 2] > threshold) lmax[count++] = k + (i - k) / 2;
+      }
+    }
+    else if (in[i + 1] - in[i] > 0) up = true;
+  }
+  return count;
+}
+
+
+/** Reference sort of local maxima by decreasing magnitude (stable). */
+static void referenceSort (int *lmax, int n, const int *val)
+{
+  for (int i = 1; i < n; i ++)
+  {
+    int j = i, tmp = lmax[i];
+    while (j > 0 && val[tmp] > val[lmax[j-1]])
+    {
+      lmax[j] = lmax[j-1];
+      j --;
+    }
+    lmax[j] = tmp;
+  }
+}
+
+
+/** Returns whether two local max lists are equal. */
+static bool sameMax (const int *l1, int n1, const int *l2, int n2)
+{
+  if (n1 != n2) return false;
+  for (int i = 0; i < n1; i++) if (l1[i] != l2[i]) return false;
+  return true;
+}
+
+
+/**
+ * Compares the local max search of the map on random scans with the
+ *   reference search, with and without SSE2 when available, and lazily
+ *   sorted maxima with fully sorted ones.
+ * Returns the count of failed comparisons.
+ */
+static int checkLocalMax (int gtype)
+{
+  int w = SIGNAL_WIDTH;
+  int **im = new int*[w];
+  randomState = 7 + gtype;
+  for (int j = 0; j < w; j++)
+  {
+    im[j] = new int[w];
+    for (int i = 0; i < w; i++) im[j][i] = nextRandom (6) * 40;
+  }
+  VMap *gMap = new VMap (w, w, im, gtype);
+  int threshold = gMap->getGradientThreshold ();
+  if (gtype <= VMap::TYPE_SOBEL_5X5) threshold *= threshold;
+  bool sse2 = VMap::isSSE2SearchAvailable ();
+  int scan[SIGNAL_WIDTH], gn[SIGNAL_WIDTH];
+  int ref[SIGNAL_WIDTH], lmax[SIGNAL_WIDTH];
+  int fails = 0;
+
+  for (int k = 0; k < NB_SIGNALS / 8; k++)
+  {
+    // Random scan along a line or column, or scattered
+    int n = 1 + nextRandom (SIGNAL_WIDTH);
+    int kind = nextRandom (3);
+    int line = nextRandom (w);
+    for (int i = 0; i < n; i++)
+      scan[i] = (kind == 0 ? line * w + i : (kind == 1 ? i * w + line
+                                             : nextRandom (w * w)));
+    int gx = nextRandom (21) - 10;
+    int gy = nextRandom (21) - 10;
+    if (gx == 0 && gy == 0) gy = 1;
+    Vr2i gref (gx, gy);
+
+    // Reference search, filters and sort
+    for (int i = 0; i < n; i++) gn[i] = gMap->magn (gMap->pointAt (scan[i]));
+    int nref = referenceSearch (ref, n, gn, threshold);
+    if (gMap->isOrientationConstraintOn ())
+      nref = gMap->keepDirectedElementsAs (scan, nref, ref, gref);
+    nref = gMap->keepOrientedElementsAs (scan, nref, ref, gref);
+    referenceSort (ref, nref, gn);
+
+    for (int s = 0; s < (sse2 ? 2 : 1); s++)
+    {
+      VMap::setSSE2Search (s == 1);
+      int nb = gMap->localMax (lmax, scan, n, gref);
+      if (! sameMax (ref, nref, lmax, nb)) fails ++;
+      nb = gMap->localMax (lmax, scan, n, gref, 1);
+      for (int i = 1; i < nb; i++) gMap->sortNextMax (lmax, i, nb);
+      if (! sameMax (ref, nref, lmax, nb)) fails ++;
+    }
+  }
+  VMap::setSSE2Search (sse2);
+  delete gMap;
+  for (int j = 0; j < w; j++) delete [] im[j];
+  delete [] im;
+  return (fails);
+}
+
+
+int main ()
+{
+  bool ok = true;
+  int fails = checkWalk ();
+  if (fails != 0)
+  {
+    cout << "Scan line kernel : FAILED (" << fails << " differences)" << endl;
+    ok = false;
+  }
+  else cout << "Scan line kernel : OK" << endl;
+
+  fails = checkScanners ();
+  if (fails != 0)
+  {
+    cout << "Scanners : FAILED (" << fails << " wrong scans)" << endl;
+    ok = false;
+  }
+  else cout << "Scanners : OK" << endl;
+
+  fails = 0;
+  for (int gtype = 0; gtype <= VMap::TYPE_FULL_MORPHO; gtype++)
+    fails += checkLocalMax (gtype);
+  if (fails != 0)
+  {
+    cout << "Local max search : FAILED (" << fails << " differences)"
+         << endl;
+    ok = false;
+  }
+  else cout << "Local max search : OK" << endl;
+
+  return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
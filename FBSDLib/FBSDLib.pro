@@ -0,0 +1,93 @@
+######################################################################
+# Detection core as a library, without any Qt dependency
+######################################################################
+
+QT -= core gui
+CONFIG += staticlib thread
+CONFIG -= qt
+TEMPLATE = lib
+TARGET = fbsd
+QMAKE_CXXFLAGS += -std=c++11
+INCLUDEPATH += .. \
+           ../BlurredSegment \
+           ../DirectionalScanner \
+           ../ConvexHull \
+           ../ImageTools
+# Per-stage detection profiling (see BSProfiler)
+# DEFINES += FBSD_PROFILING
+OBJECTS_DIR = obj
+
+# Input
+HEADERS += linedetector.h \
+           ../BlurredSegment/biptlist.h \
+           ../BlurredSegment/blurredsegment.h \
+           ../BlurredSegment/blurredsegmentproto.h \
+           ../BlurredSegment/bsdetector.h \
+           ../BlurredSegment/bstracker.h \
+           ../BlurredSegment/bsfilter.h \
+           ../BlurredSegment/bsprofiler.h \
+           ../ConvexHull/antipodal.h \
+           ../ConvexHull/chvertex.h \
+           ../ConvexHull/chvertexarena.h \
+           ../ConvexHull/convexhull.h \
+           ../DirectionalScanner/directionalscanner.h \
+           ../DirectionalScanner/directionalscannero1.h \
+           ../DirectionalScanner/directionalscannero2.h \
+           ../DirectionalScanner/directionalscannero7.h \
+           ../DirectionalScanner/directionalscannero8.h \
+           ../DirectionalScanner/adaptivescannero1.h \
+           ../DirectionalScanner/adaptivescannero2.h \
+           ../DirectionalScanner/adaptivescannero7.h \
+           ../DirectionalScanner/adaptivescannero8.h \
+           ../DirectionalScanner/scannerprovider.h \
+           ../DirectionalScanner/vhscannero1.h \
+           ../DirectionalScanner/vhscannero2.h \
+           ../DirectionalScanner/vhscannero7.h \
+           ../DirectionalScanner/vhscannero8.h \
+           ../ImageTools/absrat.h \
+           ../ImageTools/bitmask.h \
+           ../ImageTools/digitalstraightline.h \
+           ../ImageTools/digitalstraightsegment.h \
+           ../ImageTools/intervalmask.h \
+           ../ImageTools/pt2i.h \
+           ../ImageTools/ptspan.h \
+           ../ImageTools/sobel5x5.h \
+           ../ImageTools/strucel.h \
+           ../ImageTools/vmap.h \
+           ../ImageTools/vr2i.h
+SOURCES += linedetector.cpp \
+           ../BlurredSegment/biptlist.cpp \
+           ../BlurredSegment/blurredsegment.cpp \
+           ../BlurredSegment/blurredsegmentproto.cpp \
+           ../BlurredSegment/bsdetector.cpp \
+           ../BlurredSegment/bstracker.cpp \
+           ../BlurredSegment/bsfilter.cpp \
+           ../BlurredSegment/bsprofiler.cpp \
+           ../ConvexHull/antipodal.cpp \
+           ../ConvexHull/chvertex.cpp \
+           ../ConvexHull/chvertexarena.cpp \
+           ../ConvexHull/convexhull.cpp \
+           ../DirectionalScanner/directionalscanner.cpp \
+           ../DirectionalScanner/directionalscannero1.cpp \
+           ../DirectionalScanner/directionalscannero2.cpp \
+           ../DirectionalScanner/directionalscannero7.cpp \
+           ../DirectionalScanner/directionalscannero8.cpp \
+           ../DirectionalScanner/adaptivescannero1.cpp \
+           ../DirectionalScanner/adaptivescannero2.cpp \
+           ../DirectionalScanner/adaptivescannero7.cpp \
+           ../DirectionalScanner/adaptivescannero8.cpp \
+           ../DirectionalScanner/scannerprovider.cpp \
+           ../DirectionalScanner/vhscannero1.cpp \
+           ../DirectionalScanner/vhscannero2.cpp \
+           ../DirectionalScanner/vhscannero7.cpp \
+           ../DirectionalScanner/vhscannero8.cpp \
+           ../ImageTools/absrat.cpp \
+           ../ImageTools/bitmask.cpp \
+           ../ImageTools/digitalstraightline.cpp \
+           ../ImageTools/digitalstraightsegment.cpp \
+           ../ImageTools/intervalmask.cpp \
+           ../ImageTools/pt2i.cpp \
+           ../ImageTools/sobel5x5.cpp \
+           ../ImageTools/strucel.cpp \
+           ../ImageTools/vmap.cpp \
+           ../ImageTools/vr2i.cpp
@@ -0,0 +1,111 @@
+#include "linedetector.h"
+#include <cmath>
+
+
+LineDetector::LineDetector ()
+{
+  gMap = NULL;
+  gtype = VMap::TYPE_SOBEL_5X5;
+  intervalMask = false;
+  tracking = false;
+}
+
+
+LineDetector::~LineDetector ()
+{
+  if (gMap != NULL) delete gMap;
+}
+
+
+int LineDetector::detect (const unsigned char *data, int width, int height,
+                          int stride)
+{
+  segs.clear ();
+  if (data == NULL || width <= 0 || height <= 0) return 0;
+  if (stride == 0) stride = width;
+
+  // Image lines are stored bottom up as in the rest of the detector
+  pixels.resize (width * height);
+  lines.resize (height);
+  for (int i = 0; i < height; i++)
+  {
+    int *pix = &(pixels[i * width]);
+    const unsigned char *in = data + (height - 1 - i) * stride;
+    for (int j = 0; j < width; j++) pix[j] = (int) in[j];
+    lines[i] = pix;
+  }
+
+  VMap *former = gMap;
+  bool sameSize = (former != NULL && former->getWidth () == width
+                   && former->getHeight () == height);
+  gMap = new VMap (width, height, &(lines[0]), gtype);
+  if (intervalMask) gMap->setIntervalMask (true);
+  detector.setGradientMap (gMap);
+  if (former != NULL) delete former;
+  if (tracking && sameSize) detector.trackAll ();
+  else detector.detectAll ();
+  collectSegments (height);
+  return ((int) (segs.size ()));
+}
+
+
+int LineDetector::redetect (const unsigned char *data, int width, int height,
+                            int x0, int y0, int sizex, int sizey, int stride)
+{
+  if (gMap == NULL || gMap->getWidth () != width
+      || gMap->getHeight () != height)
+    return (detect (data, width, height, stride));
+  segs.clear ();
+  if (data == NULL) return 0;
+  if (stride == 0) stride = width;
+
+  // Copies the changed lines (bottom up)
+  int x1 = (x0 < 0 ? 0 : x0);
+  int x2 = (x0 + sizex > width ? width : x0 + sizex);
+  int i1 = height - (y0 + sizey), i2 = height - y0;
+  if (i1 < 0) i1 = 0;
+  if (i2 > height) i2 = height;
+  for (int i = i1; i < i2; i++)
+  {
+    const unsigned char *in = data + (height - 1 - i) * stride;
+    for (int j = x1; j < x2; j++) lines[i][j] = (int) in[j];
+  }
+
+  if (x1 < x2 && i1 < i2)
+  {
+    int r = gMap->getKernelRadius ();
+    gMap->update (&(lines[0]), x1, i1, x2 - x1, i2 - i1);
+    detector.detectAll (x1 - r, i1 - r, x2 - x1 + 2 * r, i2 - i1 + 2 * r);
+  }
+  collectSegments (height);
+  return ((int) (segs.size ()));
+}
+
+
+void LineDetector::collectSegments (int height)
+{
+  AbsRat x1, y1, x2, y2;
+  vector<BlurredSegment *> bss = detector.getBlurredSegments ();
+  vector<BlurredSegment *>::iterator it = bss.begin ();
+  while (it != bss.end ())
+  {
+    if (*it != NULL)
+    {
+      DigitalStraightSegment *dss = (*it)->getSegment ();
+      if (dss != NULL)
+      {
+        dss->naiveLine (x1, y1, x2, y2);
+        AbsRat th = dss->squaredEuclideanThickness ();
+        Segment s;
+        s.x1 = x1.num () / (double) x1.den ();
+        s.y1 = height - 1 - y1.num () / (double) y1.den ();
+        s.x2 = x2.num () / (double) x2.den ();
+        s.y2 = height - 1 - y2.num () / (double) y2.den ();
+        s.thickness = sqrt (th.num () / (double) th.den ());
+        s.size = (*it)->size ();
+        segs.push_back (s);
+      }
+    }
+    it ++;
+  }
+}
@@ -0,0 +1,180 @@
+#ifndef LINE_DETECTOR_H
+#define LINE_DETECTOR_H
+
+#include "bsdetector.h"
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * @class LineDetector linedetector.h
+ * \brief Qt-free entry point to the blurred segment detector.
+ * Grey level images are given as plain 8 bit buffers and detected segments
+ *   are returned as plain values in image coordinates (origin at the top
+ *   left corner, y axis pointing downwards), as in FBSD -out mode.
+ * The detector and its work memory are kept from one image to the next.
+ * \author {P. Even}
+ */
+class LineDetector
+{
+public:
+
+  /**
+   * @struct Segment linedetector.h
+   * \brief Detected segment.
+   */
+  struct Segment
+  {
+    /** Abscissa of the naive line start point. */
+    double x1;
+    /** Ordinate of the naive line start point. */
+    double y1;
+    /** Abscissa of the naive line end point. */
+    double x2;
+    /** Ordinate of the naive line end point. */
+    double y2;
+    /** Euclidean thickness of the enclosing digital straight segment. */
+    double thickness;
+    /** Count of points of the blurred segment. */
+    int size;
+  };
+
+
+  /**
+   * \brief Creates a line detector with default settings.
+   */
+  LineDetector ();
+
+  /**
+   * \brief Deletes the line detector.
+   */
+  ~LineDetector ();
+
+  /**
+   * \brief Detects all the segments in a grey level image.
+   * Returns the count of detected segments.
+   * @param data First pixel of the top line of the image.
+   * @param width Image width.
+   * @param height Image height.
+   * @param stride Count of bytes between two successive lines
+   *   (width if null).
+   */
+  int detect (const unsigned char *data, int width, int height,
+              int stride = 0);
+
+  /**
+   * \brief Detects the segments again after a change in a rectangle of
+   *   the last processed image.
+   * Only the gradient map around the rectangle is updated and only this
+   *   area is swept again. Segments of last detection lying out of it are
+   *   kept. Runs a full detection if the image size changed.
+   * Returns the count of detected segments.
+   * @param data First pixel of the top line of the changed image.
+   * @param width Image width.
+   * @param height Image height.
+   * @param x0 Left column of the changed rectangle.
+   * @param y0 Top line of the changed rectangle.
+   * @param sizex Changed rectangle width.
+   * @param sizey Changed rectangle height.
+   * @param stride Count of bytes between two successive lines
+   *   (width if null).
+   */
+  int redetect (const unsigned char *data, int width, int height,
+                int x0, int y0, int sizex, int sizey, int stride = 0);
+
+  /**
+   * \brief Returns the segments found by last detection.
+   */
+  inline const vector<Segment> &getSegments () const { return segs; }
+
+  /**
+   * \brief Returns the gradient extraction method.
+   */
+  inline int getGradientType () const { return gtype; }
+
+  /**
+   * \brief Sets the gradient extraction method (see VMap types).
+   * @param type Gradient type.
+   */
+  inline void setGradientType (int type) { gtype = type; }
+
+  /**
+   * \brief Returns whether occupancy masks are stored as row intervals.
+   */
+  inline bool isIntervalMask () const { return intervalMask; }
+
+  /**
+   * \brief Sets the storage of occupancy masks (see VMap::setIntervalMask).
+   * @param status Required status for interval storage.
+   */
+  inline void setIntervalMask (bool status) { intervalMask = status; }
+
+  /**
+   * \brief Sets the assigned maximal thickness of detected segments.
+   * @param val New assigned thickness value.
+   */
+  inline void setAssignedThickness (int val) {
+    detector.setAssignedThickness (val); }
+
+  /**
+   * \brief Sets the minimal size of detected segments.
+   * @param val New minimal size value.
+   */
+  inline void setFinalSizeMinValue (int val) {
+    detector.setFinalSizeMinValue (val); }
+
+  /**
+   * \brief Sets the multi-thread detection modality.
+   * @param onOff Parallel detection status.
+   */
+  inline void setParallelDetection (bool onOff) {
+    if (detector.isParallelDetection () != onOff)
+      detector.switchParallelDetection (); }
+
+  /**
+   * \brief Returns whether successive images are processed as video frames.
+   */
+  inline bool isTracking () const { return tracking; }
+
+  /**
+   * \brief Sets whether successive images are processed as video frames.
+   * Segments of previous image are then searched first in the next one
+   *   if it has the same size.
+   * @param status Tracking status.
+   */
+  inline void setTracking (bool status) { tracking = status; }
+
+  /**
+   * \brief Returns the underlying detector for finer settings.
+   */
+  inline BSDetector *getDetector () { return &detector; }
+
+
+private:
+
+  /**
+   * \brief Builds the segment list from the detector output.
+   * @param height Image height.
+   */
+  void collectSegments (int height);
+
+  /** Blurred segment detector. */
+  BSDetector detector;
+  /** Gradient map of last processed image. */
+  VMap *gMap;
+  /** Gradient extraction method. */
+  int gtype;
+  /** Interval storage of occupancy masks. */
+  bool intervalMask;
+  /** Successive images processed as video frames. */
+  bool tracking;
+  /** Segments found by last detection. */
+  vector<Segment> segs;
+  /** Image lines built from the input buffer. */
+  vector<int *> lines;
+  /** Image data built from the input buffer. */
+  vector<int> pixels;
+};
+
+#endif
@@ -3,6 +3,7 @@
 ######################################################################
 
 QT+=widgets
+CONFIG += thread
 TEMPLATE = app
 TARGET = ipolDemo
 QMAKE_CXXFLAGS += -std=c++11
@@ -11,6 +12,8 @@ INCLUDEPATH += .. \
            ../DirectionalScanner \
            ../ConvexHull \
            ../ImageTools
+# Per-stage detection profiling (see BSProfiler)
+# DEFINES += FBSD_PROFILING
 OBJECTS_DIR = obj
 
 # Input
@@ -20,8 +23,10 @@ HEADERS += ../BlurredSegment/biptlist.h \
            ../BlurredSegment/bsdetector.h \
            ../BlurredSegment/bstracker.h \
            ../BlurredSegment/bsfilter.h \
+           ../BlurredSegment/bsprofiler.h \
            ../ConvexHull/antipodal.h \
            ../ConvexHull/chvertex.h \
+           ../ConvexHull/chvertexarena.h \
            ../ConvexHull/convexhull.h \
            ../DirectionalScanner/directionalscanner.h \
            ../DirectionalScanner/directionalscannero1.h \
@@ -38,9 +43,13 @@ HEADERS += ../BlurredSegment/biptlist.h \
            ../DirectionalScanner/vhscannero7.h \
            ../DirectionalScanner/vhscannero8.h \
            ../ImageTools/absrat.h \
+           ../ImageTools/bitmask.h \
            ../ImageTools/digitalstraightline.h \
            ../ImageTools/digitalstraightsegment.h \
+           ../ImageTools/intervalmask.h \
            ../ImageTools/pt2i.h \
+           ../ImageTools/ptspan.h \
+           ../ImageTools/sobel5x5.h \
            ../ImageTools/strucel.h \
            ../ImageTools/vmap.h \
            ../ImageTools/vr2i.h
@@ -51,8 +60,10 @@ SOURCES += mainIPOL.cpp \
            ../BlurredSegment/bsdetector.cpp \
            ../BlurredSegment/bstracker.cpp \
            ../BlurredSegment/bsfilter.cpp \
+           ../BlurredSegment/bsprofiler.cpp \
            ../ConvexHull/antipodal.cpp \
            ../ConvexHull/chvertex.cpp \
+           ../ConvexHull/chvertexarena.cpp \
            ../ConvexHull/convexhull.cpp \
            ../DirectionalScanner/directionalscanner.cpp \
            ../DirectionalScanner/directionalscannero1.cpp \
@@ -69,9 +80,12 @@ SOURCES += mainIPOL.cpp \
            ../DirectionalScanner/vhscannero7.cpp \
            ../DirectionalScanner/vhscannero8.cpp \
            ../ImageTools/absrat.cpp \
+           ../ImageTools/bitmask.cpp \
            ../ImageTools/digitalstraightline.cpp \
            ../ImageTools/digitalstraightsegment.cpp \
+           ../ImageTools/intervalmask.cpp \
            ../ImageTools/pt2i.cpp \
+           ../ImageTools/sobel5x5.cpp \
            ../ImageTools/strucel.cpp \
            ../ImageTools/vmap.cpp \
            ../ImageTools/vr2i.cpp
@@ -0,0 +1,78 @@
+#include "bitmask.h"
+
+
+const int BitMask::CHUNK_SHIFT = 12;
+const int BitMask::CHUNK_WORDS = 64;
+
+
+BitMask::BitMask (int size)
+{
+  nbcells = size;
+  nbchunks = (size >> CHUNK_SHIFT) + 1;
+  bits = new uint64_t[nbchunks * CHUNK_WORDS];
+  stamps = new uint32_t[nbchunks];
+  for (int i = 0; i < nbchunks; i++) stamps[i] = 0;
+  epoch = 1;
+}
+
+
+BitMask::~BitMask ()
+{
+  delete [] bits;
+  delete [] stamps;
+}
+
+
+void BitMask::clear ()
+{
+  if (++epoch == 0)
+  {
+    for (int i = 0; i < nbchunks; i++) stamps[i] = 0;
+    epoch = 1;
+  }
+}
+
+
+void BitMask::setRange (int k1, int k2)
+{
+  int clast = k2 >> CHUNK_SHIFT;
+  for (int c = k1 >> CHUNK_SHIFT; c <= clast; c++)
+    if (stamps[c] != epoch) renew (c);
+  int w1 = k1 >> 6, w2 = k2 >> 6;
+  uint64_t m1 = (~((uint64_t) 0)) << (k1 & 63);
+  uint64_t m2 = (~((uint64_t) 0)) >> (63 - (k2 & 63));
+  if (w1 == w2) bits[w1] |= (m1 & m2);
+  else
+  {
+    bits[w1] |= m1;
+    for (int w = w1 + 1; w < w2; w++) bits[w] = ~((uint64_t) 0);
+    bits[w2] |= m2;
+  }
+}
+
+
+void BitMask::unsetRange (int k1, int k2)
+{
+  int w1 = k1 >> 6, w2 = k2 >> 6;
+  int wshift = CHUNK_SHIFT - 6;
+  uint64_t m1 = (~((uint64_t) 0)) << (k1 & 63);
+  uint64_t m2 = (~((uint64_t) 0)) >> (63 - (k2 & 63));
+  for (int w = w1; w <= w2; w++)
+  {
+    if (stamps[w >> wshift] == epoch)
+    {
+      uint64_t m = ~((uint64_t) 0);
+      if (w == w1) m &= m1;
+      if (w == w2) m &= m2;
+      bits[w] &= ~m;
+    }
+  }
+}
+
+
+void BitMask::renew (int c)
+{
+  uint64_t *w = bits + c * CHUNK_WORDS;
+  for (int i = 0; i < CHUNK_WORDS; i++) *w++ = 0;
+  stamps[c] = epoch;
+}
@@ -0,0 +1,114 @@
+#ifndef BIT_MASK_H
+#define BIT_MASK_H
+
+#include <stdint.h>
+
+using namespace std;
+
+
+/**
+ * @class BitMask bitmask.h
+ * \brief Bit-packed occupancy mask with constant time clearing.
+ * Cells are addressed by their index in the image array (y * width + x).
+ * Bits are grouped in chunks stamped with the epoch of their last write :
+ *   clearing the mask just starts a new epoch, and the out-of-date chunks
+ *   are only zeroed when a cell in them is set again.
+ * \author {P. Even}
+ */
+class BitMask
+{
+public:
+
+  /**
+   * \brief Creates a clear mask.
+   * @param size Count of mask cells.
+   */
+  BitMask (int size);
+
+  /**
+   * \brief Deletes the mask.
+   */
+  ~BitMask ();
+
+  /**
+   * \brief Returns the count of mask cells.
+   */
+  inline int size () const { return nbcells; }
+
+  /**
+   * \brief Returns the memory used by the mask in bytes.
+   */
+  inline int memorySize () const {
+    return (nbchunks * (CHUNK_WORDS * (int) sizeof (uint64_t)
+                        + (int) sizeof (uint32_t))); }
+
+  /**
+   * \brief Clears all the cells of the mask.
+   */
+  void clear ();
+
+  /**
+   * \brief Tests if a cell is set.
+   * @param k Cell index.
+   */
+  inline bool isSet (int k) const {
+    return (stamps[k >> CHUNK_SHIFT] == epoch
+            && ((bits[k >> 6] >> (k & 63)) & 1) != 0); }
+
+  /**
+   * \brief Sets a cell.
+   * @param k Cell index.
+   */
+  inline void set (int k) {
+    if (stamps[k >> CHUNK_SHIFT] != epoch) renew (k >> CHUNK_SHIFT);
+    bits[k >> 6] |= ((uint64_t) 1) << (k & 63); }
+
+  /**
+   * \brief Unsets a cell.
+   * @param k Cell index.
+   */
+  inline void unset (int k) {
+    if (stamps[k >> CHUNK_SHIFT] == epoch)
+      bits[k >> 6] &= ~(((uint64_t) 1) << (k & 63)); }
+
+  /**
+   * \brief Sets a range of successive cells.
+   * @param k1 First cell index.
+   * @param k2 Last cell index (included).
+   */
+  void setRange (int k1, int k2);
+
+  /**
+   * \brief Unsets a range of successive cells.
+   * @param k1 First cell index.
+   * @param k2 Last cell index (included).
+   */
+  void unsetRange (int k1, int k2);
+
+
+private:
+
+  /** Binary logarithm of the count of cells in a chunk. */
+  static const int CHUNK_SHIFT;
+  /** Count of words in a chunk. */
+  static const int CHUNK_WORDS;
+
+  /** Count of mask cells. */
+  int nbcells;
+  /** Count of chunks. */
+  int nbchunks;
+  /** Bit words. */
+  uint64_t *bits;
+  /** Epoch of the last write in each chunk. */
+  uint32_t *stamps;
+  /** Current epoch. */
+  uint32_t epoch;
+
+  /**
+   * \brief Zeroes an out-of-date chunk and stamps it with current epoch.
+   * @param c Chunk index.
+   */
+  void renew (int c);
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "intervalmask.h"
+
+
+IntervalMask::IntervalMask (int width, int height)
+{
+  this->width = width;
+  rows.resize (height);
+  listed.resize (height, false);
+}
+
+
+int IntervalMask::memorySize () const
+{
+  int nb = (int) (rows.size () * sizeof (vector<int>)
+                  + used.capacity () * sizeof (int));
+  vector<int>::const_iterator it = used.begin ();
+  while (it != used.end ())
+    nb += (int) (rows[*it++].capacity () * sizeof (int));
+  return nb;
+}
+
+
+void IntervalMask::clear ()
+{
+  vector<int>::iterator it = used.begin ();
+  while (it != used.end ())
+  {
+    rows[*it].clear ();
+    listed[*it++] = false;
+  }
+  used.clear ();
+}
+
+
+int IntervalMask::firstRunFrom (const vector<int> &run, int x)
+{
+  int lo = 0, hi = (int) (run.size ()) / 2;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (run[2 * mid + 1] < x) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
+bool IntervalMask::isSet (int x, int y) const
+{
+  const vector<int> &run = rows[y];
+  if (run.empty ()) return false;
+  int i = firstRunFrom (run, x);
+  return (2 * i < (int) (run.size ()) && run[2 * i] <= x);
+}
+
+
+void IntervalMask::setRange (int y, int x1, int x2)
+{
+  vector<int> &run = rows[y];
+  if (run.empty ())
+  {
+    if (! listed[y])
+    {
+      used.push_back (y);
+      listed[y] = true;
+    }
+    run.push_back (x1);
+    run.push_back (x2);
+    return;
+  }
+
+  // Runs from first to last - 1 touch or overlap [x1, x2]
+  int nbruns = (int) (run.size ()) / 2;
+  int first = firstRunFrom (run, x1 - 1);
+  int last = first;
+  while (last < nbruns && run[2 * last] <= x2 + 1) last ++;
+  if (first == last)
+    run.insert (run.begin () + 2 * first, 2, x1);
+  else
+  {
+    if (run[2 * first] < x1) x1 = run[2 * first];
+    if (run[2 * last - 1] > x2) x2 = run[2 * last - 1];
+    run.erase (run.begin () + 2 * first + 2, run.begin () + 2 * last);
+  }
+  run[2 * first] = x1;
+  run[2 * first + 1] = x2;
+}
+
+
+void IntervalMask::unsetRange (int y, int x1, int x2)
+{
+  vector<int> &run = rows[y];
+  if (run.empty ()) return;
+
+  // Runs from first to last - 1 overlap [x1, x2]
+  int nbruns = (int) (run.size ()) / 2;
+  int first = firstRunFrom (run, x1);
+  int last = first;
+  while (last < nbruns && run[2 * last] <= x2) last ++;
+  if (first == last) return;
+
+  int left = run[2 * first], right = run[2 * last - 1];
+  run.erase (run.begin () + 2 * first, run.begin () + 2 * last);
+  int pos = 2 * first;
+  if (left < x1)
+  {
+    int rem[2] = {left, x1 - 1};
+    run.insert (run.begin () + pos, rem, rem + 2);
+    pos += 2;
+  }
+  if (right > x2)
+  {
+    int rem[2] = {x2 + 1, right};
+    run.insert (run.begin () + pos, rem, rem + 2);
+  }
+}
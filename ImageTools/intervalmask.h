@@ -0,0 +1,92 @@
+#ifndef INTERVAL_MASK_H
+#define INTERVAL_MASK_H
+
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * @class IntervalMask intervalmask.h
+ * \brief Occupancy mask stored as sorted runs of set cells on each row.
+ * Memory only depends on the count of runs, which suits large images
+ *   where few cells are set. Clearing only visits the rows in use.
+ * \author {P. Even}
+ */
+class IntervalMask
+{
+public:
+
+  /**
+   * \brief Creates a clear mask.
+   * @param width Count of cells on each row.
+   * @param height Count of rows.
+   */
+  IntervalMask (int width, int height);
+
+  /**
+   * \brief Returns the count of cells on each row.
+   */
+  inline int getWidth () const { return width; }
+
+  /**
+   * \brief Returns the memory used by the runs in bytes.
+   */
+  int memorySize () const;
+
+  /**
+   * \brief Clears all the cells of the mask.
+   */
+  void clear ();
+
+  /**
+   * \brief Tests if a cell is set.
+   * @param x Cell column.
+   * @param y Cell row.
+   */
+  bool isSet (int x, int y) const;
+
+  /**
+   * \brief Sets a run of cells on a row.
+   * @param y Row index.
+   * @param x1 First cell column.
+   * @param x2 Last cell column (included).
+   */
+  void setRange (int y, int x1, int x2);
+
+  /**
+   * \brief Unsets a run of cells on a row.
+   * @param y Row index.
+   * @param x1 First cell column.
+   * @param x2 Last cell column (included).
+   */
+  void unsetRange (int y, int x1, int x2);
+
+  /**
+   * \brief Returns the count of runs on a row.
+   * @param y Row index.
+   */
+  inline int runCount (int y) const {
+    return ((int) (rows[y].size ()) / 2); }
+
+
+private:
+
+  /** Count of cells on each row. */
+  int width;
+  /** Runs of each row as sorted pairs of first and last columns. */
+  vector<vector<int> > rows;
+  /** Rows that hold runs since last clearing. */
+  vector<int> used;
+  /** Flags of the rows listed as used. */
+  vector<bool> listed;
+
+  /**
+   * \brief Returns the index of the first run ending at or after a column.
+   * @param run Runs of a row.
+   * @param x Column.
+   */
+  static int firstRunFrom (const vector<int> &run, int x);
+};
+
+#endif
@@ -517,6 +517,12 @@ Pt2i *Pt2i::pathTo (Pt2i p, int *n) const
 
 
 bool *Pt2i::stepsTo (Pt2i p, int *n) const
+{
+  return (stepsTo (p, n, new bool[chessboard (p)]));
+}
+
+
+bool *Pt2i::stepsTo (Pt2i p, int *n, bool *st) const
 {
   bool negx = p.xp < xp;
   bool negy = p.yp < yp;
@@ -537,7 +543,7 @@ bool *Pt2i::stepsTo (Pt2i p, int *n) const
 
   int x = 0;
   *n = x2;
-  bool *paliers = new bool[x2];
+  bool *paliers = st;
   while (x < x2)
   {
     e -= dy;
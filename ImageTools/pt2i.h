@@ -237,6 +237,16 @@ public:
    */
   bool *stepsTo (Pt2i p, int *n) const;
 
+  /**
+   * @fn bool *stepsTo (Pt2i p, int *n, bool *st)
+   * \brief Fills in the location of the steps to reach the given point.
+   * Returns the provided array.
+   * @param p the given point.
+   * @param n size of the filled in array.
+   * @param st array to fill in, at least as long as the chessboard distance.
+   */
+  bool *stepsTo (Pt2i p, int *n, bool *st) const;
+
   /**
    * @fn vector<Pt2i> drawOrtho (const Pt2i p2, int offset) const
    * \brief Returns the segment orthogonal to the segment to p2.
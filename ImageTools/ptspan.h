@@ -0,0 +1,92 @@
+#ifndef PT_SPAN_H
+#define PT_SPAN_H
+
+#include "pt2i.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+
+/** 
+ * @class PtSpan ptspan.h
+ * \brief Read-only view on a contiguous sequence of points.
+ * The view does not own the points : it is only valid as long as the
+ *   viewed container is not modified.
+ * \author {P. Even}
+ */
+class PtSpan
+{
+public:
+
+  /**
+   * \brief Creates an empty view.
+   */
+  PtSpan () : first (NULL), count (0) { }
+
+  /**
+   * \brief Creates a view on an array of points.
+   * @param pts First viewed point.
+   * @param n Count of viewed points.
+   */
+  PtSpan (const Pt2i *pts, int n) : first (pts), count (n) { }
+
+  /**
+   * \brief Creates a view on the contents of a vector of points.
+   * @param pts Viewed vector.
+   */
+  PtSpan (const vector<Pt2i> &pts)
+    : first (pts.empty () ? NULL : &(pts[0])), count ((int) (pts.size ())) { }
+
+  /**
+   * \brief Returns the count of viewed points.
+   */
+  inline int size () const { return (count); }
+
+  /**
+   * \brief Checks whether the view is empty.
+   */
+  inline bool empty () const { return (count == 0); }
+
+  /**
+   * \brief Returns the first viewed point address.
+   */
+  inline const Pt2i *begin () const { return (first); }
+
+  /**
+   * \brief Returns the address after the last viewed point.
+   */
+  inline const Pt2i *end () const { return (first + count); }
+
+  /**
+   * \brief Returns the viewed point of given rank.
+   * @param i Point rank in the view.
+   */
+  inline const Pt2i &operator[] (int i) const { return (first[i]); }
+
+  /**
+   * \brief Returns the first viewed point.
+   */
+  inline const Pt2i &front () const { return (first[0]); }
+
+  /**
+   * \brief Returns the last viewed point.
+   */
+  inline const Pt2i &back () const { return (first[count - 1]); }
+
+  /**
+   * \brief Returns a copy of the viewed points.
+   */
+  inline vector<Pt2i> toVector () const {
+    return (vector<Pt2i> (first, first + count)); }
+
+
+private:
+
+  /** First viewed point. */
+  const Pt2i *first;
+  /** Count of viewed points. */
+  int count;
+};
+
+#endif
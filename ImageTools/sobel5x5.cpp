@@ -0,0 +1,342 @@
+#include "sobel5x5.h"
+#include "math.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOBEL_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+
+const int Sobel5x5::SCALAR = 0;
+const int Sobel5x5::SSE2 = 1;
+const int Sobel5x5::AVX2 = 2;
+const int Sobel5x5::KERNEL_GAIN = 84;
+
+int Sobel5x5::iset = Sobel5x5::bestInstructionSet ();
+
+
+int Sobel5x5::bestInstructionSet ()
+{
+#ifdef SOBEL_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) return AVX2;
+  if (__builtin_cpu_supports ("sse2")) return SSE2;
+#endif
+  return SCALAR;
+}
+
+
+void Sobel5x5::setInstructionSet (int set)
+{
+  int best = bestInstructionSet ();
+  iset = (set < SCALAR || set > best ? best : set);
+}
+
+
+void Sobel5x5::gradient (Vr2i *map, int *mag, int **data,
+                         int width, int height)
+{
+  Vr2i *gm = map;
+  for (int j = 0; j < 2 * width; j++) (gm++)->set (0, 0);
+  if (mag != NULL)
+    for (int j = 0; j < 2 * width; j++) mag[j] = 0;
+
+  int *buf = new int[5 * width];
+  for (int i = 2; i < height - 2; i++)
+  {
+    line (data, i, width, gm, (mag != NULL ? mag + i * width : NULL), buf);
+    gm += width;
+  }
+  delete [] buf;
+
+  for (int j = 0; j < 2 * width; j++) (gm++)->set (0, 0);
+  if (mag != NULL)
+    for (int j = (height - 2) * width; j < height * width; j++) mag[j] = 0;
+}
+
+
+void Sobel5x5::gradient (int16_t *gx, int16_t *gy, uint16_t *mag, int **data,
+                         int width, int height)
+{
+  for (int j = 0; j < 2 * width; j++) gx[j] = gy[j] = mag[j] = 0;
+
+  int *buf = new int[5 * width];
+  Vr2i *gm = new Vr2i[width];
+  int *ml = new int[width];
+  for (int i = 2; i < height - 2; i++)
+  {
+    line (data, i, width, gm, ml, buf);
+    int16_t *ox = gx + i * width;
+    int16_t *oy = gy + i * width;
+    uint16_t *om = mag + i * width;
+    for (int j = 0; j < width; j++)
+    {
+      ox[j] = (int16_t) gm[j].x ();
+      oy[j] = (int16_t) gm[j].y ();
+      om[j] = (uint16_t) ml[j];
+    }
+  }
+  delete [] ml;
+  delete [] gm;
+  delete [] buf;
+
+  for (int j = (height - 2) * width; j < height * width; j++)
+    gx[j] = gy[j] = mag[j] = 0;
+}
+
+
+void Sobel5x5::line (int **data, int i, int width,
+                     Vr2i *gm, int *mag, int *buf)
+{
+  int *v1 = buf;
+  int *v2 = v1 + width;
+  int *hp = v2 + width;
+  int *hq = hp + width;
+  int *hr = hq + width;
+
+  // Vertical pass
+  int j = 0;
+  if (iset == AVX2) j = columnPassAVX2 (data + i - 2, width,
+                                        v1, v2, hp, hq, hr);
+  else if (iset == SSE2) j = columnPassSSE2 (data + i - 2, width,
+                                             v1, v2, hp, hq, hr);
+  columnPass (data + i - 2, j, width, v1, v2, hp, hq, hr);
+
+  // Horizontal pass
+  j = 2;
+  if (iset == AVX2) j = linePassAVX2 (gm, mag, width, v1, v2, hp, hq, hr);
+  else if (iset == SSE2) j = linePassSSE2 (gm, mag, width,
+                                           v1, v2, hp, hq, hr);
+  linePass (gm, mag, j, width - 2, v1, v2, hp, hq, hr);
+
+  // Borders
+  gm[0].set (0, 0);
+  gm[1].set (0, 0);
+  gm[width - 2].set (0, 0);
+  gm[width - 1].set (0, 0);
+  if (mag != NULL) mag[0] = mag[1] = mag[width - 2] = mag[width - 1] = 0;
+}
+
+
+void Sobel5x5::columnPass (int *const *r, int from, int to,
+                           int *v1, int *v2, int *hp, int *hq, int *hr)
+{
+  for (int j = from; j < to; j++)
+  {
+    int s = r[0][j] + r[4][j];
+    int t = r[1][j] + r[3][j];
+    int c = r[2][j];
+    int d2 = r[4][j] - r[0][j];
+    int d1 = r[3][j] - r[1][j];
+    v1[j] = 5 * s + 8 * t + 10 * c;
+    v2[j] = 4 * s + 10 * t + 20 * c;
+    hp[j] = 5 * d2 + 4 * d1;
+    hq[j] = 8 * d2 + 10 * d1;
+    hr[j] = 10 * d2 + 20 * d1;
+  }
+}
+
+
+void Sobel5x5::linePass (Vr2i *gm, int *mag, int from, int to,
+                         const int *v1, const int *v2,
+                         const int *hp, const int *hq, const int *hr)
+{
+  for (int j = from; j < to; j++)
+  {
+    int gx = v1[j + 2] - v1[j - 2] + v2[j + 1] - v2[j - 1];
+    int gy = hp[j - 2] + hp[j + 2] + hq[j - 1] + hq[j + 1] + hr[j];
+    gm[j].set (gx, gy);
+    if (mag != NULL)
+      mag[j] = (int) sqrt ((double) gx * gx + (double) gy * gy);
+  }
+}
+
+
+#ifdef SOBEL_X86
+
+// Products by the kernel coefficients, with shifts and adds only.
+#define MUL4_128(v) _mm_slli_epi32 (v, 2)
+#define MUL5_128(v) _mm_add_epi32 (_mm_slli_epi32 (v, 2), v)
+#define MUL8_128(v) _mm_slli_epi32 (v, 3)
+#define MUL10_128(v) _mm_add_epi32 (_mm_slli_epi32 (v, 3), _mm_slli_epi32 (v, 1))
+#define MUL20_128(v) _mm_add_epi32 (_mm_slli_epi32 (v, 4), _mm_slli_epi32 (v, 2))
+#define MUL4_256(v) _mm256_slli_epi32 (v, 2)
+#define MUL5_256(v) _mm256_add_epi32 (_mm256_slli_epi32 (v, 2), v)
+#define MUL8_256(v) _mm256_slli_epi32 (v, 3)
+#define MUL10_256(v) _mm256_add_epi32 (_mm256_slli_epi32 (v, 3), \
+                                       _mm256_slli_epi32 (v, 1))
+#define MUL20_256(v) _mm256_add_epi32 (_mm256_slli_epi32 (v, 4), \
+                                       _mm256_slli_epi32 (v, 2))
+#define LOAD_128(p) _mm_loadu_si128 ((const __m128i *) (p))
+#define STORE_128(p, v) _mm_storeu_si128 ((__m128i *) (p), v)
+#define LOAD_256(p) _mm256_loadu_si256 ((const __m256i *) (p))
+#define STORE_256(p, v) _mm256_storeu_si256 ((__m256i *) (p), v)
+
+
+__attribute__ ((target ("sse2")))
+int Sobel5x5::columnPassSSE2 (int *const *r, int width,
+                              int *v1, int *v2, int *hp, int *hq, int *hr)
+{
+  int j = 0;
+  for (; j + 4 <= width; j += 4)
+  {
+    __m128i a = LOAD_128 (r[0] + j);
+    __m128i b = LOAD_128 (r[1] + j);
+    __m128i c = LOAD_128 (r[2] + j);
+    __m128i d = LOAD_128 (r[3] + j);
+    __m128i e = LOAD_128 (r[4] + j);
+    __m128i s = _mm_add_epi32 (a, e);
+    __m128i t = _mm_add_epi32 (b, d);
+    __m128i d2 = _mm_sub_epi32 (e, a);
+    __m128i d1 = _mm_sub_epi32 (d, b);
+    STORE_128 (v1 + j, _mm_add_epi32 (_mm_add_epi32 (MUL5_128 (s),
+                                                     MUL8_128 (t)),
+                                      MUL10_128 (c)));
+    STORE_128 (v2 + j, _mm_add_epi32 (_mm_add_epi32 (MUL4_128 (s),
+                                                     MUL10_128 (t)),
+                                      MUL20_128 (c)));
+    STORE_128 (hp + j, _mm_add_epi32 (MUL5_128 (d2), MUL4_128 (d1)));
+    STORE_128 (hq + j, _mm_add_epi32 (MUL8_128 (d2), MUL10_128 (d1)));
+    STORE_128 (hr + j, _mm_add_epi32 (MUL10_128 (d2), MUL20_128 (d1)));
+  }
+  return j;
+}
+
+
+__attribute__ ((target ("sse2")))
+int Sobel5x5::linePassSSE2 (Vr2i *gm, int *mag, int width,
+                            const int *v1, const int *v2,
+                            const int *hp, const int *hq, const int *hr)
+{
+  int j = 2;
+  for (; j + 4 <= width - 2; j += 4)
+  {
+    __m128i gx = _mm_add_epi32 (
+                   _mm_sub_epi32 (LOAD_128 (v1 + j + 2), LOAD_128 (v1 + j - 2)),
+                   _mm_sub_epi32 (LOAD_128 (v2 + j + 1), LOAD_128 (v2 + j - 1)));
+    __m128i gy = _mm_add_epi32 (
+                   _mm_add_epi32 (LOAD_128 (hp + j - 2), LOAD_128 (hp + j + 2)),
+                   _mm_add_epi32 (
+                     _mm_add_epi32 (LOAD_128 (hq + j - 1),
+                                    LOAD_128 (hq + j + 1)),
+                     LOAD_128 (hr + j)));
+    int *out = (int *) (gm + j);
+    STORE_128 (out, _mm_unpacklo_epi32 (gx, gy));
+    STORE_128 (out + 4, _mm_unpackhi_epi32 (gx, gy));
+    if (mag != NULL)
+    {
+      __m128d xl = _mm_cvtepi32_pd (gx);
+      __m128d yl = _mm_cvtepi32_pd (gy);
+      __m128d xh = _mm_cvtepi32_pd (_mm_shuffle_epi32 (gx, 0xEE));
+      __m128d yh = _mm_cvtepi32_pd (_mm_shuffle_epi32 (gy, 0xEE));
+      __m128i ml = _mm_cvttpd_epi32 (_mm_sqrt_pd (
+                     _mm_add_pd (_mm_mul_pd (xl, xl), _mm_mul_pd (yl, yl))));
+      __m128i mh = _mm_cvttpd_epi32 (_mm_sqrt_pd (
+                     _mm_add_pd (_mm_mul_pd (xh, xh), _mm_mul_pd (yh, yh))));
+      STORE_128 (mag + j, _mm_unpacklo_epi64 (ml, mh));
+    }
+  }
+  return j;
+}
+
+
+__attribute__ ((target ("avx2")))
+int Sobel5x5::columnPassAVX2 (int *const *r, int width,
+                              int *v1, int *v2, int *hp, int *hq, int *hr)
+{
+  int j = 0;
+  for (; j + 8 <= width; j += 8)
+  {
+    __m256i a = LOAD_256 (r[0] + j);
+    __m256i b = LOAD_256 (r[1] + j);
+    __m256i c = LOAD_256 (r[2] + j);
+    __m256i d = LOAD_256 (r[3] + j);
+    __m256i e = LOAD_256 (r[4] + j);
+    __m256i s = _mm256_add_epi32 (a, e);
+    __m256i t = _mm256_add_epi32 (b, d);
+    __m256i d2 = _mm256_sub_epi32 (e, a);
+    __m256i d1 = _mm256_sub_epi32 (d, b);
+    STORE_256 (v1 + j, _mm256_add_epi32 (_mm256_add_epi32 (MUL5_256 (s),
+                                                           MUL8_256 (t)),
+                                         MUL10_256 (c)));
+    STORE_256 (v2 + j, _mm256_add_epi32 (_mm256_add_epi32 (MUL4_256 (s),
+                                                           MUL10_256 (t)),
+                                         MUL20_256 (c)));
+    STORE_256 (hp + j, _mm256_add_epi32 (MUL5_256 (d2), MUL4_256 (d1)));
+    STORE_256 (hq + j, _mm256_add_epi32 (MUL8_256 (d2), MUL10_256 (d1)));
+    STORE_256 (hr + j, _mm256_add_epi32 (MUL10_256 (d2), MUL20_256 (d1)));
+  }
+  return j;
+}
+
+
+__attribute__ ((target ("avx2")))
+int Sobel5x5::linePassAVX2 (Vr2i *gm, int *mag, int width,
+                            const int *v1, const int *v2,
+                            const int *hp, const int *hq, const int *hr)
+{
+  int j = 2;
+  for (; j + 8 <= width - 2; j += 8)
+  {
+    __m256i gx = _mm256_add_epi32 (
+             _mm256_sub_epi32 (LOAD_256 (v1 + j + 2), LOAD_256 (v1 + j - 2)),
+             _mm256_sub_epi32 (LOAD_256 (v2 + j + 1), LOAD_256 (v2 + j - 1)));
+    __m256i gy = _mm256_add_epi32 (
+             _mm256_add_epi32 (LOAD_256 (hp + j - 2), LOAD_256 (hp + j + 2)),
+             _mm256_add_epi32 (
+               _mm256_add_epi32 (LOAD_256 (hq + j - 1), LOAD_256 (hq + j + 1)),
+               LOAD_256 (hr + j)));
+    __m256i lo = _mm256_unpacklo_epi32 (gx, gy);
+    __m256i hi = _mm256_unpackhi_epi32 (gx, gy);
+    int *out = (int *) (gm + j);
+    STORE_256 (out, _mm256_permute2x128_si256 (lo, hi, 0x20));
+    STORE_256 (out + 8, _mm256_permute2x128_si256 (lo, hi, 0x31));
+    if (mag != NULL)
+    {
+      __m256d xl = _mm256_cvtepi32_pd (_mm256_castsi256_si128 (gx));
+      __m256d yl = _mm256_cvtepi32_pd (_mm256_castsi256_si128 (gy));
+      __m256d xh = _mm256_cvtepi32_pd (_mm256_extracti128_si256 (gx, 1));
+      __m256d yh = _mm256_cvtepi32_pd (_mm256_extracti128_si256 (gy, 1));
+      __m128i ml = _mm256_cvttpd_epi32 (_mm256_sqrt_pd (_mm256_add_pd (
+                     _mm256_mul_pd (xl, xl), _mm256_mul_pd (yl, yl))));
+      __m128i mh = _mm256_cvttpd_epi32 (_mm256_sqrt_pd (_mm256_add_pd (
+                     _mm256_mul_pd (xh, xh), _mm256_mul_pd (yh, yh))));
+      STORE_128 (mag + j, ml);
+      STORE_128 (mag + j + 4, mh);
+    }
+  }
+  return j;
+}
+
+#else
+
+int Sobel5x5::columnPassSSE2 (int *const *, int, int *, int *,
+                              int *, int *, int *)
+{
+  return 0;
+}
+
+
+int Sobel5x5::linePassSSE2 (Vr2i *, int *, int, const int *, const int *,
+                            const int *, const int *, const int *)
+{
+  return 2;
+}
+
+
+int Sobel5x5::columnPassAVX2 (int *const *, int, int *, int *,
+                              int *, int *, int *)
+{
+  return 0;
+}
+
+
+int Sobel5x5::linePassAVX2 (Vr2i *, int *, int, const int *, const int *,
+                            const int *, const int *, const int *)
+{
+  return 2;
+}
+
+#endif
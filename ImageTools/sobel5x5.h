@@ -0,0 +1,159 @@
+#ifndef SOBEL_5X5_H
+#define SOBEL_5X5_H
+
+#include "vr2i.h"
+#include <stdint.h>
+
+using namespace std;
+
+
+/**
+ * @class Sobel5x5 sobel5x5.h
+ * \brief Sobel gradient extraction with a 5x5 kernel.
+ * The kernel is split in vertical and horizontal 1D passes, processed with
+ *   SSE2 or AVX2 instructions when available (checked at run time).
+ * All instruction sets provide exactly the same integer results.
+ * \author {P. Even}
+ */
+class Sobel5x5
+{
+public:
+
+  /** Instruction set : plain C++. */
+  static const int SCALAR;
+  /** Instruction set : SSE2 (4 pixels per instruction). */
+  static const int SSE2;
+  /** Instruction set : AVX2 (8 pixels per instruction). */
+  static const int AVX2;
+
+
+  /**
+   * \brief Returns the best instruction set supported by the processor.
+   */
+  static int bestInstructionSet ();
+
+  /**
+   * \brief Returns the instruction set in use.
+   */
+  static inline int getInstructionSet () { return iset; }
+
+  /**
+   * \brief Sets the instruction set in use.
+   * Unsupported instruction sets are replaced by the best supported one.
+   * @param set Required instruction set.
+   */
+  static void setInstructionSet (int set);
+
+  /**
+   * \brief Calculates the Sobel 5x5 gradient of an image.
+   * Two pixel wide borders are set to null vectors.
+   * @param map Output gradient array (the memory should be allocated before).
+   * @param mag Output magnitude array (gradient norm), ignored if NULL.
+   * @param data Image bi-dimensional array.
+   * @param width Image width.
+   * @param height Image height.
+   */
+  static void gradient (Vr2i *map, int *mag, int **data,
+                        int width, int height);
+
+  /**
+   * \brief Calculates the Sobel 5x5 gradient of an image on 16 bit planes.
+   * The image range should be small enough to avoid overflows
+   *   (see maxSafeRange).
+   * @param gx Output gradient abscissa plane.
+   * @param gy Output gradient ordinate plane.
+   * @param mag Output magnitude plane (gradient norm).
+   * @param data Image bi-dimensional array.
+   * @param width Image width.
+   * @param height Image height.
+   */
+  static void gradient (int16_t *gx, int16_t *gy, uint16_t *mag, int **data,
+                        int width, int height);
+
+  /**
+   * \brief Returns the maximal image range compatible with 16 bit planes.
+   */
+  static inline int maxSafeRange () { return (INT16_MAX / KERNEL_GAIN); }
+
+
+private:
+
+  /** Sum of the positive coefficients of the kernel. */
+  static const int KERNEL_GAIN;
+  /** Instruction set in use. */
+  static int iset;
+
+  /**
+   * \brief Computes the gradient on an image line (borders excluded).
+   * @param data Image bi-dimensional array.
+   * @param i Index of the processed line.
+   * @param width Image width.
+   * @param gm Output gradient line.
+   * @param mag Output magnitude line, ignored if NULL.
+   * @param buf Work array of size 5 * width.
+   */
+  static void line (int **data, int i, int width,
+                    Vr2i *gm, int *mag, int *buf);
+
+  /**
+   * \brief Computes the vertical pass of the kernel on pixels [from, to[.
+   * @param r Five successive image lines centered on the processed one.
+   * @param from First processed pixel.
+   * @param to Pixel after the last processed one.
+   * @param v1 Outer column smoothing.
+   * @param v2 Inner column smoothing.
+   * @param hp Line difference weighted for the outer columns.
+   * @param hq Line difference weighted for the inner columns.
+   * @param hr Line difference weighted for the central column.
+   */
+  static void columnPass (int *const *r, int from, int to,
+                          int *v1, int *v2, int *hp, int *hq, int *hr);
+
+  /**
+   * \brief Computes the horizontal pass of the kernel on pixels [from, to[.
+   * @param gm Output gradient line.
+   * @param mag Output magnitude line, ignored if NULL.
+   * @param from First processed pixel.
+   * @param to Pixel after the last processed one.
+   * @param v1 Outer column smoothing.
+   * @param v2 Inner column smoothing.
+   * @param hp Line difference weighted for the outer columns.
+   * @param hq Line difference weighted for the inner columns.
+   * @param hr Line difference weighted for the central column.
+   */
+  static void linePass (Vr2i *gm, int *mag, int from, int to,
+                        const int *v1, const int *v2,
+                        const int *hp, const int *hq, const int *hr);
+
+  /**
+   * \brief Computes the vertical pass with SSE2 instructions from pixel 0.
+   * Returns the first pixel left to the plain C++ pass.
+   */
+  static int columnPassSSE2 (int *const *r, int width,
+                             int *v1, int *v2, int *hp, int *hq, int *hr);
+
+  /**
+   * \brief Computes the horizontal pass with SSE2 instructions from pixel 2.
+   * Returns the first pixel left to the plain C++ pass.
+   */
+  static int linePassSSE2 (Vr2i *gm, int *mag, int width,
+                           const int *v1, const int *v2,
+                           const int *hp, const int *hq, const int *hr);
+
+  /**
+   * \brief Computes the vertical pass with AVX2 instructions from pixel 0.
+   * Returns the first pixel left to the plain C++ pass.
+   */
+  static int columnPassAVX2 (int *const *r, int width,
+                             int *v1, int *v2, int *hp, int *hq, int *hr);
+
+  /**
+   * \brief Computes the horizontal pass with AVX2 instructions from pixel 2.
+   * Returns the first pixel left to the plain C++ pass.
+   */
+  static int linePassAVX2 (Vr2i *gm, int *mag, int width,
+                           const int *v1, const int *v2,
+                           const int *hp, const int *hq, const int *hr);
+};
+
+#endif
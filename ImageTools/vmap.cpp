@@ -2,6 +2,11 @@
 #include "vmap.h"
 #include "math.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VMAP_X86
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 
@@ -21,6 +26,9 @@ const int VMap::DEFAULT_GRADIENT_RESOLUTION = 100;
 const int VMap::MAX_BOWL = 20;
 const int VMap::NB_DILATIONS = 5;
 const int VMap::DEFAULT_DILATION = 4;
+const int VMap::STENCIL_RADIUS = 2;
+
+bool VMap::sse2Search = VMap::isSSE2SearchAvailable ();
 
 
 VMap::VMap (int width, int height, int *data, int type)
@@ -106,7 +114,8 @@ VMap::VMap (int width, int height, int *data, int type)
   {
     buildSobel5x5Map (data);
     for (int i = 0; i < width * height; i++)
-      imap[i] = (int) sqrt (map[i].norm2 ());
+      imap[i] = (int) sqrt ((double) map[i].x () * map[i].x ()
+                            + (double) map[i].y () * map[i].y ());
     gmagThreshold *= gradientThreshold;
   }
   else if (type == TYPE_SOBEL_3X3)
@@ -116,6 +125,7 @@ VMap::VMap (int width, int height, int *data, int type)
       imap[i] = (int) sqrt (map[i].norm2 ());
     gmagThreshold *= gradientThreshold;
   }
+  compactMaps ();
 }
 
 
@@ -200,9 +210,7 @@ VMap::VMap (int width, int height, int **data, int type)
   }
   else if (type == TYPE_SOBEL_5X5)
   {
-    buildSobel5x5Map (data);
-    for (int i = 0; i < width * height; i++)
-      imap[i] = (int) sqrt (map[i].norm2 ());
+    if (! buildCompactSobel5x5Map (data)) buildSobel5x5Map (data, true);
     gmagThreshold *= gradientThreshold;
   }
   else if (type == TYPE_SOBEL_3X3)
@@ -212,16 +220,52 @@ VMap::VMap (int width, int height, int **data, int type)
       imap[i] = (int) sqrt (map[i].norm2 ());
     gmagThreshold *= gradientThreshold;
   }
+  if (! compact) compactMaps ();
+}
+
+
+VMap::VMap (const VMap *model)
+{
+  this->width = model->width;
+  this->height = model->height;
+  this->gtype = model->gtype;
+  init ();
+  map = model->map;
+  imap = model->imap;
+  compact = model->compact;
+  gxmap = model->gxmap;
+  gymap = model->gymap;
+  cmap = model->cmap;
+  shared = true;
+  angleThreshold = model->angleThreshold;
+  gradientThreshold = model->gradientThreshold;
+  gmagThreshold = model->gmagThreshold;
+  gradres = model->gradres;
+  orientedGradient = model->orientedGradient;
+  maskDilation = model->maskDilation;
+  masking = model->masking;
+  intervals = model->intervals;
 }
 
 
 VMap::~VMap ()
 {
-  delete [] map;
-  delete [] imap;
-  delete [] mask;
+  if (! shared)
+  {
+    delete [] map;
+    delete [] imap;
+    delete [] gxmap;
+    delete [] gymap;
+    delete [] cmap;
+  }
+  if (mask != NULL) delete mask;
+  if (imask != NULL) delete imask;
+  delete [] scangn;
+  delete [] scanmin;
+  delete [] scanfired;
   delete [] dilations;
   delete [] bowl;
+  delete [] stencil;
 }
 
 
@@ -230,8 +274,16 @@ void VMap::init ()
   gradientThreshold = DEFAULT_GRADIENT_THRESHOLD;
   gmagThreshold = gradientThreshold;
   gradres = DEFAULT_GRADIENT_RESOLUTION;
-  mask = new bool[width * height];
-  for (int i = 0; i < width * height; i++) mask[i] = false;
+  map = NULL;
+  imap = NULL;
+  shared = false;
+  compact = false;
+  gxmap = NULL;
+  gymap = NULL;
+  cmap = NULL;
+  mask = NULL;
+  imask = NULL;
+  intervals = false;
   masking = false;
   angleThreshold = NEAR_SQ_ANGLE;
   orientedGradient = true;
@@ -263,6 +315,27 @@ void VMap::init ()
   dilations[3] = 12;
   dilations[4] = 20;
   maskDilation = DEFAULT_DILATION;
+  buildStencil ();
+  scangn = NULL;
+  scanmin = NULL;
+  scanfired = NULL;
+  scratchSize = 0;
+  scratchAllocs = 0;
+  reserveScratch (getHeightWidthMax () + 1);
+}
+
+
+void VMap::reserveScratch (int n) const
+{
+  if (n <= scratchSize) return;
+  delete [] scangn;
+  delete [] scanmin;
+  delete [] scanfired;
+  scratchSize = n;
+  scangn = new int[n];
+  scanmin = new int[n];
+  scanfired = new bool[n];
+  scratchAllocs ++;
 }
 
 
@@ -310,18 +383,22 @@ void VMap::buildGradientMap (int *data)
 void VMap::buildGradientMap (int **data)
 {
   map = new Vr2i[width * height];
-  Vr2i *gm = map;
+  sobel3x3 (map, data, width, height);
+}
 
-  for (int j = 0; j < width; j++)
+
+void VMap::sobel3x3 (Vr2i *gm, int **data, int w, int h)
+{
+  for (int j = 0; j < w; j++)
   {
     gm->set (0, 0);
     gm++;
   }
-  for (int i = 1; i < height - 1; i++)
+  for (int i = 1; i < h - 1; i++)
   {
     gm->set (0, 0);
     gm++;
-    for (int j = 1; j < width - 1; j++)
+    for (int j = 1; j < w - 1; j++)
     {
       gm->set (data[i-1][j+1] + 2 * data[i][j+1] + data[i+1][j+1]
                - data[i-1][j-1] - 2 * data[i][j-1] - data[i+1][j-1],
@@ -332,7 +409,7 @@ void VMap::buildGradientMap (int **data)
     gm->set (0, 0);
     gm++;
   }
-  for (int j = 0; j < width; j++)
+  for (int j = 0; j < w; j++)
   {
     gm->set (0, 0);
     gm++;
@@ -413,65 +490,199 @@ void VMap::buildSobel5x5Map (int *data)
 }
 
 
-void VMap::buildSobel5x5Map (int **data)
+void VMap::buildSobel5x5Map (int **data, bool magnitude)
 {
   map = new Vr2i[width * height];
-  Vr2i *gm = map;
+  Sobel5x5::gradient (map, (magnitude ? imap : NULL), data, width, height);
+}
 
-  for (int j = 0; j < 2 * width; j++)
+
+bool VMap::buildCompactSobel5x5Map (int **data)
+{
+  int vmin = data[0][0], vmax = data[0][0];
+  for (int i = 0; i < height; i++)
+    for (int j = 0; j < width; j++)
+    {
+      if (data[i][j] < vmin) vmin = data[i][j];
+      else if (data[i][j] > vmax) vmax = data[i][j];
+    }
+  if (vmax - vmin > Sobel5x5::maxSafeRange ()) return false;
+
+  delete [] imap;
+  imap = NULL;
+  gxmap = new int16_t[width * height];
+  gymap = new int16_t[width * height];
+  cmap = new uint16_t[width * height];
+  Sobel5x5::gradient (gxmap, gymap, cmap, data, width, height);
+  compact = true;
+  return true;
+}
+
+
+void VMap::compactMaps ()
+{
+  int n = width * height;
+  for (int i = 0; i < n; i++)
+    if (map[i].x () < INT16_MIN || map[i].x () > INT16_MAX
+        || map[i].y () < INT16_MIN || map[i].y () > INT16_MAX
+        || imap[i] < 0 || imap[i] > UINT16_MAX) return;
+
+  gxmap = new int16_t[n];
+  gymap = new int16_t[n];
+  cmap = new uint16_t[n];
+  for (int i = 0; i < n; i++)
   {
-    gm->set (0, 0);
-    gm++;
+    gxmap[i] = (int16_t) map[i].x ();
+    gymap[i] = (int16_t) map[i].y ();
+    cmap[i] = (uint16_t) imap[i];
   }
-  for (int i = 2; i < height - 2; i++)
+  delete [] map;
+  delete [] imap;
+  map = NULL;
+  imap = NULL;
+  compact = true;
+}
+
+
+void VMap::expandMaps ()
+{
+  int n = width * height;
+  map = new Vr2i[n];
+  imap = new int[n];
+  for (int i = 0; i < n; i++)
   {
-    gm->set (0, 0);
-    gm++;
-    gm->set (0, 0);
-    gm++;
-    for (int j = 2; j < width - 2; j++)
+    map[i].set (gxmap[i], gymap[i]);
+    imap[i] = cmap[i];
+  }
+  delete [] gxmap;
+  delete [] gymap;
+  delete [] cmap;
+  gxmap = NULL;
+  gymap = NULL;
+  cmap = NULL;
+  compact = false;
+}
+
+
+void VMap::update (int **data, int x0, int y0, int sizex, int sizey)
+{
+  if (shared) return;
+  int r = getKernelRadius ();
+
+  // Updated rectangle : changed pixels and their kernel border
+  int ux1 = (x0 - r < 0 ? 0 : x0 - r);
+  int uy1 = (y0 - r < 0 ? 0 : y0 - r);
+  int ux2 = (x0 + sizex + r > width ? width : x0 + sizex + r);
+  int uy2 = (y0 + sizey + r > height ? height : y0 + sizey + r);
+  if (ux1 >= ux2 || uy1 >= uy2) return;
+
+  // Input window : updated rectangle and its kernel border
+  int wx1 = (ux1 - r < 0 ? 0 : ux1 - r);
+  int wy1 = (uy1 - r < 0 ? 0 : uy1 - r);
+  int ww = (ux2 + r > width ? width : ux2 + r) - wx1;
+  int wh = (uy2 + r > height ? height : uy2 + r) - wy1;
+  int **win = new int*[wh];
+  for (int j = 0; j < wh; j++) win[j] = data[wy1 + j] + wx1;
+  Vr2i *wmap = new Vr2i[ww * wh];
+  int *wmag = new int[ww * wh];
+  computeVectors (wmap, wmag, win, ww, wh);
+
+  if (compact)
+  {
+    bool fits = true;
+    for (int j = uy1; fits && j < uy2; j++)
     {
-      gm->set (
-        5 * data[i-2][j+2] + 8 * data[i-1][j+2] + 10 * data[i][j+2]
-                           + 8 * data[i+1][j+2] + 5 * data[i+2][j+2]
-        + 4 * data[i-2][j+1] + 10 * data[i-1][j+1] + 20 * data[i][j+1]
-                           + 10 * data[i+1][j+1] + 4 * data[i+2][j+1]
-        - 4 * data[i-2][j-1] - 10 * data[i-1][j-1] - 20 * data[i][j-1]
-                           - 10 * data[i+1][j-1] - 4 * data[i+2][j-1]
-        - 5 * data[i-2][j-2] - 8 * data[i-1][j-2] - 10 * data[i][j-2]
-                           - 8 * data[i+1][j-2] - 5 * data[i+2][j-2],
-        5 * data[i+2][j-2] + 8 * data[i+2][j-1] + 10 * data[i+2][j]
-                           + 8 * data[i+2][j+1] + 5 * data[i+2][j+2]
-        + 4 * data[i+1][j-2] + 10 * data[i+1][j-1] + 20 * data[i+1][j]
-                           + 10 * data[i+1][j+1] + 4 * data[i+1][j+2]
-        - 4 * data[i-1][j-2] - 10 * data[i-1][j-1] - 20 * data[i-1][j]
-                           - 10 * data[i-1][j+1] - 4 * data[i-1][j+2]
-        - 5 * data[i-2][j-2] - 8 * data[i-2][j-1] - 10 * data[i-2][j]
-                           - 8 * data[i-2][j+1] - 5 * data[i-2][j+2]);
-      gm++;
+      int k = (j - wy1) * ww + ux1 - wx1;
+      for (int i = ux1; fits && i < ux2; i++, k++)
+        if (wmap[k].x () < INT16_MIN || wmap[k].x () > INT16_MAX
+            || wmap[k].y () < INT16_MIN || wmap[k].y () > INT16_MAX
+            || wmag[k] < 0 || wmag[k] > UINT16_MAX) fits = false;
     }
-    gm->set (0, 0);
-    gm++;
-    gm->set (0, 0);
-    gm++;
+    if (! fits) expandMaps ();
   }
-  for (int j = 0; j < 2 * width; j++)
+  for (int j = uy1; j < uy2; j++)
   {
-    gm->set (0, 0);
-    gm++;
+    int k = (j - wy1) * ww + ux1 - wx1;
+    for (int i = j * width + ux1; i < j * width + ux2; i++, k++)
+    {
+      if (compact)
+      {
+        gxmap[i] = (int16_t) wmap[k].x ();
+        gymap[i] = (int16_t) wmap[k].y ();
+        cmap[i] = (uint16_t) wmag[k];
+      }
+      else
+      {
+        map[i] = wmap[k];
+        imap[i] = wmag[k];
+      }
+    }
+  }
+  delete [] wmag;
+  delete [] wmap;
+  delete [] win;
+}
+
+
+void VMap::computeVectors (Vr2i *gm, int *mag, int **data, int w, int h) const
+{
+  if (gtype == TYPE_TOP_HAT || gtype == TYPE_BLACK_HAT
+      || gtype == TYPE_MORPHO)
+  {
+    Strucel se (Strucel::TYPE_PLUS_3X3);
+    if (gtype == TYPE_TOP_HAT) se.tophatGradient (mag, data, w, h);
+    else if (gtype == TYPE_BLACK_HAT) se.blackhatGradient (mag, data, w, h);
+    else se.morphoGradient (mag, data, w, h);
+    Sobel5x5::gradient (gm, NULL, data, w, h);
+  }
+  else if (gtype == TYPE_FULL_TOP_HAT || gtype == TYPE_FULL_BLACK_HAT
+           || gtype == TYPE_FULL_MORPHO)
+  {
+    Strucel se (Strucel::TYPE_PLUS_3X3);
+    Strucel seh (Strucel::TYPE_HOR);
+    Strucel sev (Strucel::TYPE_VER);
+    int *jmap = new int[w * h];
+    int *kmap = new int[w * h];
+    if (gtype == TYPE_FULL_TOP_HAT)
+    {
+      se.tophatGradient (mag, data, w, h);
+      seh.tophatGradient (jmap, data, w, h);
+      sev.tophatGradient (kmap, data, w, h);
+    }
+    else if (gtype == TYPE_FULL_BLACK_HAT)
+    {
+      se.blackhatGradient (mag, data, w, h);
+      seh.blackhatGradient (jmap, data, w, h);
+      sev.blackhatGradient (kmap, data, w, h);
+    }
+    else
+    {
+      se.morphoGradient (mag, data, w, h);
+      seh.morphoGradient (jmap, data, w, h);
+      sev.morphoGradient (kmap, data, w, h);
+    }
+    for (int i = 0; i < w * h; i ++) gm[i].set (jmap[i], kmap[i]);
+    delete [] jmap;
+    delete [] kmap;
+  }
+  else if (gtype == TYPE_SOBEL_5X5) Sobel5x5::gradient (gm, mag, data, w, h);
+  else
+  {
+    sobel3x3 (gm, data, w, h);
+    for (int i = 0; i < w * h; i++) mag[i] = (int) sqrt (gm[i].norm2 ());
   }
 }
 
 
 int VMap::sqNorm (int i, int j) const
 {
-  return (map[j * width + i].norm2 ());
+  return (vectorAt (j * width + i).norm2 ());
 }
 
 
 int VMap::sqNorm (Pt2i p) const
 {
-  return (map[p.y () * width + p.x ()].norm2 ());
+  return (vectorAt (p.y () * width + p.x ()).norm2 ());
 }
 
 
@@ -481,13 +692,13 @@ int VMap::largestIn (const vector<Pt2i> &pix) const
 
   int imax = -1;
   vector<Pt2i>::const_iterator pt = pix.begin ();
-  int gmax = imap[pt->y() * width + pt->x()];
+  int gmax = magnAt (pt->y() * width + pt->x());
   if (gmax < gmagThreshold) gmax = gmagThreshold;
 
   int i = 0;
   while (pt != pix.end ())
   {
-    int g = imap[pt->y() * width + pt->x()];
+    int g = magnAt (pt->y() * width + pt->x());
     if (g > gmax)
     {
       gmax = g;
@@ -500,12 +711,53 @@ int VMap::largestIn (const vector<Pt2i> &pix) const
 }
 
 
+int VMap::largestIn (const int *scan, int n) const
+{
+  if (n == 0) return (-1);
+
+  int imax = -1;
+  int gmax = magnAt (scan[0]);
+  if (gmax < gmagThreshold) gmax = gmagThreshold;
+
+  for (int i = 0; i < n; i++)
+  {
+    int g = magnAt (scan[i]);
+    if (g > gmax)
+    {
+      gmax = g;
+      imax = i;
+    }
+  }
+  return (imax == n - 1 ? -1 : imax);
+}
+
+
+int VMap::keepFreeElementsIn (const int *scan, int n, int *ind) const
+{
+  if (mask == NULL && imask == NULL) return (n);
+  int i = 0;
+  while (i < n)
+  {
+    bool occ = (imask != NULL ?
+                imask->isSet (scan[ind[i]] % width, scan[ind[i]] / width) :
+                mask->isSet (scan[ind[i]]));
+    if (occ) ind[i] = ind[--n];
+    else i++;
+  }
+  return (n);
+}
+
+
 int VMap::keepFreeElementsIn (const vector<Pt2i> &pix, int n, int *ind) const
 {
+  if (mask == NULL && imask == NULL) return (n);
   int i = 0;
   while (i < n)
   {
-    if (mask[pix[ind[i]].y () * width + pix[ind[i]].x ()]) ind[i] = ind[--n];
+    const Pt2i &p = pix[ind[i]];
+    bool occ = (imask != NULL ? imask->isSet (p.x (), p.y ()) :
+                                mask->isSet (p.y () * width + p.x ()));
+    if (occ) ind[i] = ind[--n];
     else i++;
   }
   return (n);
@@ -515,8 +767,9 @@ int VMap::keepFreeElementsIn (const vector<Pt2i> &pix, int n, int *ind) const
 int VMap::keepContrastedMax (int *lmax, int n, int *in) const
 {
   if (n == 0) return 0;
-  int *min = new int[n-1];
-  bool *fired = new bool[n];
+  reserveScratch (n);
+  int *min = scanmin;
+  bool *fired = scanfired;
   int nbfired = 0;
   int sleft = 0;
 
@@ -574,7 +827,23 @@ int VMap::keepDirectedElementsAs (const vector<Pt2i> &pix,
   int i = 0;
   while (i < n)
   {
-    Vr2i gr = map[pix[ind[i]].y () * width + pix[ind[i]].x ()];
+    Vr2i gr = vectorAt (pix[ind[i]].y () * width + pix[ind[i]].x ());
+    if (vx * gr.x () + vy * gr.y () <= 0) ind[i] = ind[--n];
+    else i++;
+  }
+  return (n);
+}
+
+
+int VMap::keepDirectedElementsAs (const int *scan,
+                                  int n, int *ind, const Vr2i &ref) const
+{
+  int vx = ref.x ();
+  int vy = ref.y ();
+  int i = 0;
+  while (i < n)
+  {
+    Vr2i gr = vectorAt (scan[ind[i]]);
     if (vx * gr.x () + vy * gr.y () <= 0) ind[i] = ind[--n];
     else i++;
   }
@@ -593,7 +862,7 @@ int VMap::keepOrientedElementsAs (const vector<Pt2i> &pix,
   while (i < n)
   {
     Pt2i p = pix.at (ind[i]);
-    Vr2i gr = map[p.y () * width + p.x ()];
+    Vr2i gr = vectorAt (p.y () * width + p.x ());
     long gx = gr.x ();
     long gy = gr.y ();
     if ((vx * vx * gx * gx + vy * vy * gy * gy + 2 * vx * vy * gx * gy) * 100
@@ -609,7 +878,8 @@ int VMap::localMax (int *lmax, const vector<Pt2i> &pix) const
 {
   // Builds the gradient norm signal
   int n = (int) pix.size ();
-  int *gn = new int[n];
+  reserveScratch (n);
+  int *gn = scangn;
   int i = 0;
   vector<Pt2i>::const_iterator it = pix.begin ();
   while (it != pix.end ()) gn[i++] = magn (*it++);
@@ -626,16 +896,38 @@ int VMap::localMax (int *lmax, const vector<Pt2i> &pix) const
   // Sorts candidates by gradient magnitude
   sortMax (lmax, count, gn);
 
-  delete gn;
   return count;
 }
 
 
+int VMap::keepOrientedElementsAs (const int *scan,
+                                  int n, int *ind, const Vr2i &ref) const
+{
+  int vx = ref.x ();
+  int vy = ref.y ();
+  long vn2 = vx * vx + vy * vy;
+
+  int i = 0;
+  while (i < n)
+  {
+    Vr2i gr = vectorAt (scan[ind[i]]);
+    long gx = gr.x ();
+    long gy = gr.y ();
+    if ((vx * vx * gx * gx + vy * vy * gy * gy + 2 * vx * vy * gx * gy) * 100
+        < vn2 * (gx * gx + gy * gy) * angleThreshold)
+      ind[i] = ind[--n];
+    else i++;
+  }
+  return (n);
+}
+
+
 int VMap::localMax (int *lmax, const vector<Pt2i> &pix, const Vr2i &gref) const
 {
   // Builds the gradient norm signal
   int n = (int) pix.size ();
-  int *gn = new int[n];
+  reserveScratch (n);
+  int *gn = scangn;
   int i = 0;
   vector<Pt2i>::const_iterator it = pix.begin ();
   while (it != pix.end ()) gn[i++] = magn (*it++);
@@ -657,55 +949,112 @@ int VMap::localMax (int *lmax, const vector<Pt2i> &pix, const Vr2i &gref) const
   // Sorts candidates by gradient magnitude
   sortMax (lmax, count, gn);
 
-  delete gn;
+  return count;
+}
+
+
+int VMap::localMax (int *lmax, const int *scan, int n,
+                    const Vr2i &gref, int nbsorted) const
+{
+  // Builds the gradient norm signal
+  reserveScratch (n);
+  int *gn = scangn;
+  for (int i = 0; i < n; i++) gn[i] = magnAt (scan[i]);
+
+  // Gets the local maxima
+  int count = searchLocalMax (lmax, n, gn);
+
+  // Prunes the already selected candidates
+  if (masking)
+    count = keepFreeElementsIn (scan, count, lmax);
+
+  // Prunes the candidates with opposite gradient
+  if (orientedGradient)
+    count = keepDirectedElementsAs (scan, count, lmax, gref);
+
+  // Prunes the candidates wrongly oriented
+  count = keepOrientedElementsAs (scan, count, lmax, gref);
+
+  // Sorts candidates by gradient magnitude
+  sortMax (lmax, count, gn, nbsorted);
+
   return count;
 }
 
 
 int VMap::searchLocalMax (int *lmax, int n, int *in) const
 {
-  int offset = 0;
+  // Maxima are centers of plateaus between lower values
   int count = 0;
-  bool up = true;
+  int k = 1;
+  if (sse2Search) k = searchLocalMaxSSE2 (lmax, n, in, count);
+  for (; k < n - 1; k++)
+    if (in[k] > in[k - 1] && in[k] >= in[k + 1] && in[k] > gmagThreshold)
+      k = addPlateauMax (lmax, count, n, in, k);
+  return count;
+}
 
-  // Gets the first distinct value from start
-  while (offset < n - 1 && in[offset] == in[0])
-  {
-    if (in[offset] - in[offset + 1] < 0)
-    {
-      up = true;
-      break;
-    }
-    if (in[offset] - in[offset + 1] > 0)
-    {
-      up = false;
-      break;
-    }
-    offset++;
-  }
 
-  for(int i = offset; i < n - 1; i++)
+bool VMap::isSSE2SearchAvailable ()
+{
+#ifdef VMAP_X86
+  __builtin_cpu_init ();
+  return (__builtin_cpu_supports ("sse2"));
+#else
+  return false;
+#endif
+}
+
+
+void VMap::setSSE2Search (bool status)
+{
+  sse2Search = status && isSSE2SearchAvailable ();
+}
+
+
+#ifdef VMAP_X86
+
+__attribute__ ((target ("sse2")))
+int VMap::searchLocalMaxSSE2 (int *lmax, int n, const int *in,
+                              int &count) const
+{
+  __m128i thr = _mm_set1_epi32 (gmagThreshold);
+  int k = 1;
+  for (; k + 4 < n; k += 4)
   {
-    if (up)
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (in + k));
+    __m128i vl = _mm_loadu_si128 ((const __m128i *) (in + k - 1));
+    __m128i vr = _mm_loadu_si128 ((const __m128i *) (in + k + 1));
+    __m128i rises = _mm_and_si128 (_mm_cmpgt_epi32 (v, vl),
+                                   _mm_cmpgt_epi32 (v, thr));
+    __m128i starts = _mm_andnot_si128 (_mm_cmpgt_epi32 (vr, v), rises);
+    int bits = _mm_movemask_ps (_mm_castsi128_ps (starts));
+    while (bits != 0)
     {
-      if ((in[i + 1] - in[i]) < 0)
-      {
-        up = false;
-        int k = i;
-        while (in[k - 1] == in[i]) k--;
-        if (in[k + (i - k) / 2] > gmagThreshold)
-          lmax[count++] = k + (i - k) / 2;
-      }
+      addPlateauMax (lmax, count, n, in, k + __builtin_ctz (bits));
+      bits &= bits - 1;
     }
-    else
-      if (in[i + 1] - in[i] > 0) up = true;
   }
-  return count;
+  return k;
+}
+
+#else
+
+int VMap::searchLocalMaxSSE2 (int *, int, const int *, int &) const
+{
+  return 1;
 }
 
+#endif
+
 
-void VMap::sortMax (int *lmax, int n, int *val) const
+void VMap::sortMax (int *lmax, int n, int *val, int nbsorted) const
 {
+  if (nbsorted >= 0 && nbsorted < n)
+  {
+    for (int i = 0; i < nbsorted; i++) selectMax (lmax, i, n, val);
+    return;
+  }
   for (int i = 1; i < n; i ++)
   {
     int j = i, tmp = lmax[i];
@@ -724,25 +1073,136 @@ void VMap::sortMax (int *lmax, int n, int *val) const
 }
 
 
+void VMap::selectMax (int *lmax, int i, int n, const int *val) const
+{
+  int best = i;
+  for (int j = i + 1; j < n; j++)
+    if (val[lmax[j]] > val[lmax[best]]) best = j;
+  int tmp = lmax[best];
+  for (int j = best; j > i; j--) lmax[j] = lmax[j - 1];
+  lmax[i] = tmp;
+}
+
+
 void VMap::clearMask ()
 {
-  for (int i = 0; i < width * height; i++) mask[i] = false;
+  if (imask != NULL) imask->clear ();
+  else if (mask != NULL) mask->clear ();
 }
 
 
-void VMap::setMask (const vector<Pt2i> &pts)
+void VMap::clearMask (int x0, int y0, int sizex, int sizey)
 {
-  vector<Pt2i>::const_iterator it = pts.begin ();
+  int x1 = (x0 < 0 ? 0 : x0);
+  int x2 = (x0 + sizex > width ? width : x0 + sizex) - 1;
+  int y1 = (y0 < 0 ? 0 : y0);
+  int y2 = (y0 + sizey > height ? height : y0 + sizey) - 1;
+  if (x1 > x2 || (mask == NULL && imask == NULL)) return;
+  for (int y = y1; y <= y2; y++)
+  {
+    if (imask != NULL) imask->unsetRange (y, x1, x2);
+    else mask->unsetRange (y * width + x1, y * width + x2);
+  }
+}
+
+
+void VMap::setIntervalMask (bool status)
+{
+  if (status != intervals)
+  {
+    if (mask != NULL) delete mask;
+    if (imask != NULL) delete imask;
+    mask = NULL;
+    imask = NULL;
+    intervals = status;
+  }
+}
+
+
+void VMap::createMask ()
+{
+  if (intervals) imask = new IntervalMask (width, height);
+  else mask = new BitMask (width * height);
+}
+
+
+void VMap::buildStencil ()
+{
+  int nbrows = 2 * STENCIL_RADIUS + 1;
+  stencil = new int[NB_DILATIONS * nbrows * 2];
+  for (int d = 0; d < NB_DILATIONS; d++)
+  {
+    int *sp = stencil + d * nbrows * 2;
+    for (int r = 0; r < nbrows; r++)
+    {
+      sp[2 * r] = (r == STENCIL_RADIUS ? 0 : 1);
+      sp[2 * r + 1] = (r == STENCIL_RADIUS ? 0 : -1);
+    }
+    for (int i = 0; i < dilations[d]; i++)
+    {
+      int r = STENCIL_RADIUS + bowl[i].y ();
+      int x = bowl[i].x ();
+      if (sp[2 * r] > sp[2 * r + 1]) sp[2 * r] = sp[2 * r + 1] = x;
+      else if (x < sp[2 * r]) sp[2 * r] = x;
+      else if (x > sp[2 * r + 1]) sp[2 * r + 1] = x;
+    }
+  }
+}
+
+
+void VMap::setMask (const PtSpan &pts)
+{
+  if (mask == NULL && imask == NULL) createMask ();
+  int nbrows = 2 * STENCIL_RADIUS + 1;
+  const int *sp = stencil + maskDilation * nbrows * 2;
+  const Pt2i *it = pts.begin ();
   while (it != pts.end ())
   {
-    Pt2i pt = *it++;
-    mask[pt.y () * width + pt.x ()] = true;
-    for (int i = 0; i < dilations[maskDilation]; i++)
+    int px = it->x (), py = it->y ();
+    it ++;
+    for (int r = 0; r < nbrows; r++)
     {
-      int x = pt.x () + bowl[i].x ();
-      int y = pt.y () + bowl[i].y ();
-      if (x >= 0 && x < width && y >= 0 && y < height)
-        mask[y * width + x] = true;
+      int y = py + r - STENCIL_RADIUS;
+      if (sp[2 * r] <= sp[2 * r + 1] && y >= 0 && y < height)
+      {
+        int x1 = px + sp[2 * r], x2 = px + sp[2 * r + 1];
+        if (x1 < 0) x1 = 0;
+        if (x2 >= width) x2 = width - 1;
+        if (x1 <= x2)
+        {
+          if (imask != NULL) imask->setRange (y, x1, x2);
+          else mask->setRange (y * width + x1, y * width + x2);
+        }
+      }
+    }
+  }
+}
+
+
+void VMap::clearMask (const PtSpan &pts)
+{
+  if (mask == NULL && imask == NULL) return;
+  int nbrows = 2 * STENCIL_RADIUS + 1;
+  const int *sp = stencil + maskDilation * nbrows * 2;
+  const Pt2i *it = pts.begin ();
+  while (it != pts.end ())
+  {
+    int px = it->x (), py = it->y ();
+    it ++;
+    for (int r = 0; r < nbrows; r++)
+    {
+      int y = py + r - STENCIL_RADIUS;
+      if (sp[2 * r] <= sp[2 * r + 1] && y >= 0 && y < height)
+      {
+        int x1 = px + sp[2 * r], x2 = px + sp[2 * r + 1];
+        if (x1 < 0) x1 = 0;
+        if (x2 >= width) x2 = width - 1;
+        if (x1 <= x2)
+        {
+          if (imask != NULL) imask->unsetRange (y, x1, x2);
+          else mask->unsetRange (y * width + x1, y * width + x2);
+        }
+      }
     }
   }
 }
@@ -2,7 +2,11 @@
 #define VMAP_H
 
 #include "pt2i.h"
+#include "ptspan.h"
 #include "strucel.h"
+#include "sobel5x5.h"
+#include "bitmask.h"
+#include "intervalmask.h"
 
 using namespace std;
 
@@ -10,6 +14,8 @@ using namespace std;
 /** 
  * @class VMap vmap.h
  * \brief Vector map.
+ * When the gradient range fits, vectors and magnitudes are stored in
+ *   separate 16 bit planes (compact layout) rather than in int arrays.
  * \author {P. Even and P. Ngo}
  */
 class VMap
@@ -51,11 +57,42 @@ public:
    */
   VMap (int width, int height, int **data, int type = 0);
 
+  /** 
+   * \brief Creates a view on the gradient data of another vector map.
+   * The view shares the vector and magnitude maps of the model (which
+   *   must outlive it), copies its settings and owns its occupancy mask.
+   * Used to run concurrent detections on the same gradient map.
+   * @param model Vector map to be viewed.
+   */
+  VMap (const VMap *model);
+
   /** 
    * \brief Deletes the vector map.
    */
   ~VMap ();
 
+  /**
+   * \brief Updates the map after a change of the scalar data in a rectangle.
+   * Vectors and magnitudes are computed again in the rectangle and in its
+   *   kernel border (see getKernelRadius), exactly as done at construction
+   *   from bi-dimensional data. The occupancy mask is left unchanged.
+   * Views of the map must be created again after an update.
+   * Nothing is done on a view.
+   * @param data Whole bi-dimensional scalar data, including the changes.
+   * @param x0 Left column of the changed rectangle.
+   * @param y0 Lower line of the changed rectangle.
+   * @param sizex Changed rectangle width.
+   * @param sizey Changed rectangle height.
+   */
+  void update (int **data, int x0, int y0, int sizex, int sizey);
+
+  /**
+   * \brief Returns the distance up to which a changed pixel modifies
+   *   the vectors or magnitudes of the map.
+   */
+  inline int getKernelRadius () const {
+    return (gtype == TYPE_SOBEL_3X3 ? 1 : 2); }
+
   /** 
    * \brief Returns the map width.
    */
@@ -97,7 +134,7 @@ public:
    */
   Vr2i getValue (int i, int j) const
   {
-    return (map[j * width + i]);
+    return (vectorAt (j * width + i));
   }
 
   /**
@@ -106,7 +143,7 @@ public:
    */
   Vr2i getValue (Pt2i p) const
   {
-    return (map[p.y () * width + p.x ()]);
+    return (vectorAt (p.y () * width + p.x ()));
   }
 
   /**
@@ -127,13 +164,25 @@ public:
    * @param i Column number.
    * @param j Line number.
    */
-  inline int magn (int i, int j) const { return (imap[j * width + i]); }
+  inline int magn (int i, int j) const { return (magnAt (j * width + i)); }
 
   /**
    * \brief Returns the comparable norm of the vector magnitude at given point.
    * @param p Point position.
    */
-  inline int magn (Pt2i p) const { return (imap[p.y () * width + p.x ()]); }
+  inline int magn (Pt2i p) const {
+    return (magnAt (p.y () * width + p.x ())); }
+
+  /**
+   * \brief Checks whether the gradient is stored in 16 bit planes.
+   */
+  inline bool isCompact () const { return (compact); }
+
+  /**
+   * \brief Returns the point at given map index.
+   * @param k Map index (row-major order).
+   */
+  inline Pt2i pointAt (int k) const { return (Pt2i (k % width, k / width)); }
 
   /** 
    * \brief Returns the index of the largest vector at given positions.
@@ -144,6 +193,16 @@ public:
    */
   int largestIn (const vector<Pt2i> &pix) const;
 
+  /** 
+   * \brief Returns the index of the largest vector at given map indices.
+   *   First and last points of the list are not accepted.
+   *   A gradient minimal threshold is set for the test.
+   * Returns -1 if no max is found.
+   * @param scan Array of map indices.
+   * @param n Size of the array.
+   */
+  int largestIn (const int *scan, int n) const;
+
   /**
    * Keeps elements that are not already selected (in the mask array).
    * Returns the number of remaining elements in the selection.
@@ -153,6 +212,15 @@ public:
    */
   int keepFreeElementsIn (const vector<Pt2i> &pix, int n, int *ind) const;
 
+  /**
+   * Keeps elements that are not already selected (in the mask array).
+   * Returns the number of remaining elements in the selection.
+   * @param scan Input array of map indices.
+   * @param n Initial size of the selection of points.
+   * @param ind Selection of points.
+   */
+  int keepFreeElementsIn (const int *scan, int n, int *ind) const;
+
   /**
    * \brief Searches local gradient maxima values.
    * Returns the count of perceptible local maxima found.
@@ -174,6 +242,18 @@ public:
   int keepDirectedElementsAs (const vector<Pt2i> &pix,
                               int n, int *ind, const Vr2i &ref) const;
 
+  /**
+   * Keeps elements with the same direction as a reference vector
+   *   in a selection of map indices (positive scalar product).
+   * Returns the number of remaining elements in the selection.
+   * @param scan Input array of map indices.
+   * @param n Initial size of the selection of points.
+   * @param ind Selection of points.
+   * @param ref The reference vector.
+   */
+  int keepDirectedElementsAs (const int *scan,
+                              int n, int *ind, const Vr2i &ref) const;
+
   /**
    * Keeps elements with gradient value near a reference vector
    *   in a selection of points.
@@ -187,6 +267,19 @@ public:
   int keepOrientedElementsAs (const vector<Pt2i> &pix,
                               int n, int *ind, const Vr2i &ref) const;
 
+  /**
+   * Keeps elements with gradient value near a reference vector
+   *   in a selection of map indices.
+   * Relies on angleThreshold value for the test.
+   * Returns the number of remaining elements in the selection.
+   * @param scan Input array of map indices.
+   * @param n Initial size of the selection of points.
+   * @param ind Selection of points.
+   * @param ref The reference vector.
+   */
+  int keepOrientedElementsAs (const int *scan,
+                              int n, int *ind, const Vr2i &ref) const;
+
   /**
    * \brief Gets filtered and sorted local gradient maxima.
    * Local max already used are pruned.
@@ -206,6 +299,59 @@ public:
    */
   int localMax (int *lmax, const vector<Pt2i> &pix, const Vr2i &gref) const;
 
+  /**
+   * \brief Gets filtered and sorted local oriented gradient maxima.
+   * Local maxima are filtered according to the gradient direction and sorted.
+   * Magnitudes are directly read at the provided map indices.
+   * Only the first maxima can be sorted, when the next ones are seldom
+   *   needed : they can be sorted later with sortNextMax.
+   * Returns the count of found gradient maxima.
+   * @param lmax Local max index array.
+   * @param scan Array of map indices.
+   * @param n Size of the array.
+   * @param gref Gradient vector reference.
+   * @param nbsorted Count of sorted maxima (all if negative).
+   */
+  int localMax (int *lmax, const int *scan, int n, const Vr2i &gref,
+                int nbsorted = -1) const;
+
+  /**
+   * \brief Sorts the next gradient maximum of last local max search.
+   * Brings the largest of the unsorted maxima at given position, as a full
+   *   sort would do. The maxima before this position must be sorted.
+   * Magnitudes are read in the work array filled by the last localMax call
+   *   on this map : no other local max search must run on the map between
+   *   that call and this one.
+   * @param lmax Local max index array.
+   * @param i Position of the next sorted maximum.
+   * @param n Count of maxima.
+   */
+  inline void sortNextMax (int *lmax, int i, int n) const {
+    selectMax (lmax, i, n, scangn); }
+
+  /**
+   * \brief Returns whether the processor supports the SSE2 local max search.
+   */
+  static bool isSSE2SearchAvailable ();
+
+  /**
+   * \brief Returns whether the local max search uses SSE2 instructions.
+   */
+  static inline bool isSSE2SearchOn () { return sse2Search; }
+
+  /**
+   * \brief Sets the use of SSE2 instructions in the local max search.
+   * The setting is ignored when the processor does not support them.
+   * @param status Required status.
+   */
+  static void setSSE2Search (bool status);
+
+  /**
+   * \brief Returns the count of work array allocations of local max search.
+   * Should stay constant once the map is created.
+   */
+  inline int getScratchAllocationCount () const { return (scratchAllocs); }
+
   /**
    * \brief Returns the gradient threshold value used for maxima detection.
    */
@@ -246,20 +392,47 @@ public:
   inline bool isOrientationConstraintOn () const { return orientedGradient; }
 
   /**
-   * \brief Returns the occupancy mask contents.
+   * \brief Returns whether the occupancy mask is stored as row intervals.
    */
-  inline bool *getMask () const { return (mask); }
+  inline bool isIntervalMask () const { return intervals; }
+
+  /**
+   * \brief Selects the storage of the occupancy mask.
+   * The bit-packed storage uses one bit per pixel, the interval storage
+   *   only grows with the count of runs of occupied pixels, which suits
+   *   large and sparsely occupied images.
+   * The storage is only allocated when positions are first added, so that
+   *   the bit-packed mask is never built when intervals are selected.
+   * The mask is cleared when its storage changes.
+   * @param status Required status for interval storage.
+   */
+  void setIntervalMask (bool status);
 
   /**
    * \brief Clears the occupancy mask.
    */
   void clearMask ();
 
+  /**
+   * \brief Removes positions and their dilation from the occupancy mask.
+   * @param pts Points formerly added to the mask.
+   */
+  void clearMask (const PtSpan &pts);
+
+  /**
+   * \brief Clears the occupancy mask inside a rectangle.
+   * @param x0 Left column of the rectangle.
+   * @param y0 Lower line of the rectangle.
+   * @param sizex Rectangle width.
+   * @param sizey Rectangle height.
+   */
+  void clearMask (int x0, int y0, int sizex, int sizey);
+
   /**
    * \brief Adds positions to the occupancy mask.
-   * @param pts Vector of points.
+   * @param pts Points to add.
    */
-  void setMask (const vector<Pt2i> &pts);
+  void setMask (const PtSpan &pts);
 
   /**
    * \brief Sets mask activation on or off.
@@ -283,7 +456,8 @@ public:
    * @param pt Position to test in the mask.
    */
   inline bool isFree (const Pt2i &pt) const {
-    return (! mask[pt.y () * width + pt.x ()]); }
+    return (imask != NULL ? ! imask->isSet (pt.x (), pt.y ())
+            : (mask == NULL || ! mask->isSet (pt.y () * width + pt.x ()))); }
 
 
 private:
@@ -302,6 +476,10 @@ private:
   static const int NB_DILATIONS;
   /** Default dilation for the points added to the mask. */
   static const int DEFAULT_DILATION;
+  /** Maximal coordinate offset in the dilation bowl. */
+  static const int STENCIL_RADIUS;
+  /** Use of SSE2 instructions in the local max search. */
+  static bool sse2Search;
 
   /** Image width. */
   int width;
@@ -313,9 +491,23 @@ private:
   Vr2i *map;
   /** Magnitude map (squarred norm or morphologicalgradient). */
   int *imap;
-
-  /** Occupancy mask. */
-  bool *mask;
+  /** Flag indicating whether vector and magnitude maps are shared. */
+  bool shared;
+  /** Flag indicating whether the compact 16 bit planes are in use. */
+  bool compact;
+  /** Gradient abscissa plane (compact layout). */
+  int16_t *gxmap;
+  /** Gradient ordinate plane (compact layout). */
+  int16_t *gymap;
+  /** Magnitude plane (compact layout). */
+  uint16_t *cmap;
+
+  /** Occupancy mask (bit-packed storage). */
+  BitMask *mask;
+  /** Occupancy mask (interval storage). */
+  IntervalMask *imask;
+  /** Flag indicating whether the occupancy mask uses interval storage. */
+  bool intervals;
   /** Flag indicating whether the occupancy mask is in use. */
   bool masking;
   /** Type of dilation applied to the points added to the mask. */
@@ -324,6 +516,8 @@ private:
   int *dilations;
   /** Dilation bowl. */
   Vr2i *bowl;
+  /** Dilations as row spans (min and max abscissa offsets of each row). */
+  int *stencil;
   /** Standardized gradient threshold for highest value detection. */
   int gradientThreshold;
   /** Gradient magnitude threshold for highest value detection. */
@@ -333,12 +527,87 @@ private:
   /** Direction constraint for local gradient maxima. */
   bool orientedGradient;
 
+  /** Work array for the gradient norm signal of scanned points. */
+  mutable int *scangn;
+  /** Work array for the ponds depth in contrasted max search. */
+  mutable int *scanmin;
+  /** Work array for the pruned max in contrasted max search. */
+  mutable bool *scanfired;
+  /** Size of the work arrays. */
+  mutable int scratchSize;
+  /** Count of work array allocations. */
+  mutable int scratchAllocs;
+
 
   /** 
    * \brief Initializes the internal data of the vector map.
    */
   void init ();
 
+  /**
+   * \brief Builds the row spans of each dilation from the bowl.
+   * Each bowl row is a contiguous run of pixels.
+   */
+  void buildStencil ();
+
+  /**
+   * \brief Allocates the occupancy mask in the selected storage.
+   */
+  void createMask ();
+
+  /**
+   * \brief Ensures the work arrays hold at least n values.
+   * Arrays are sized to the largest map dimension at creation,
+   *   so that scans never need a reallocation.
+   * @param n Required size.
+   */
+  void reserveScratch (int n) const;
+
+  /**
+   * \brief Returns the vector at given array index.
+   * @param k Index in the map arrays.
+   */
+  inline Vr2i vectorAt (int k) const {
+    return (compact ? Vr2i (gxmap[k], gymap[k]) : map[k]); }
+
+  /**
+   * \brief Returns the magnitude at given array index.
+   * @param k Index in the map arrays.
+   */
+  inline int magnAt (int k) const {
+    return (compact ? (int) cmap[k] : imap[k]); }
+
+  /**
+   * \brief Moves the vector and magnitude maps to 16 bit planes.
+   * Nothing is done if some value does not fit.
+   */
+  void compactMaps ();
+
+  /**
+   * \brief Moves the vector and magnitude maps back to int arrays.
+   */
+  void expandMaps ();
+
+  /**
+   * \brief Computes vectors and magnitudes of bi-dimensional scalar data
+   *   with the gradient extraction method of the map.
+   * @param gm Output vector array (allocated before).
+   * @param mag Output magnitude array (allocated before).
+   * @param data Bi-dimensional scalar data.
+   * @param w Data width.
+   * @param h Data height.
+   */
+  void computeVectors (Vr2i *gm, int *mag, int **data, int w, int h) const;
+
+  /**
+   * \brief Computes the Sobel 3x3 gradient of bi-dimensional scalar data.
+   * @param gm Output vector array (allocated before).
+   * @param data Bi-dimensional scalar data.
+   * @param w Data width.
+   * @param h Data height.
+   */
+  static void sobel3x3 (Vr2i *gm, int **data, int w, int h);
+
   /** 
    * \brief Builds the vector map as a gradient map from provided data.
    * Uses a Sobel 3x3 kernel.
@@ -362,10 +631,19 @@ private:
 
   /** 
    * \brief Builds the vector map as a gradient map from provided data.
-   * Uses a Sobel 5x5 kernel.
+   * Uses a Sobel 5x5 kernel (vectorized when available).
    * @param data Initial bi-dimensional scalar data.
+   * @param magnitude Fills in the magnitude map in the same pass if true.
    */
-  void buildSobel5x5Map (int **data);
+  void buildSobel5x5Map (int **data, bool magnitude = false);
+
+  /** 
+   * \brief Builds compact gradient and magnitude planes from provided data.
+   * Uses a Sobel 5x5 kernel (vectorized when available).
+   * Returns false without building anything if the data range is too large.
+   * @param data Initial bi-dimensional scalar data.
+   */
+  bool buildCompactSobel5x5Map (int **data);
 
   /**
    * \brief Searches local gradient maxima values.
@@ -376,13 +654,55 @@ private:
    */
   int searchLocalMax (int *lmax, int n, int *in) const;
 
+  /**
+   * \brief Searches local gradient maxima values with SSE2 instructions.
+   * Positions are tested four at a time, plateaus are resolved one by one.
+   * Returns the first position left to be tested.
+   * @param lmax Local max index array.
+   * @param n Count of input values.
+   * @param in Array of input values.
+   * @param count Count of local maxima found (updated).
+   */
+  int searchLocalMaxSSE2 (int *lmax, int n, const int *in, int &count) const;
+
+  /**
+   * \brief Adds the center of a plateau of input values to the local maxima
+   *   if the plateau is followed by a lower value.
+   * Returns the plateau end position.
+   * @param lmax Local max index array.
+   * @param count Count of local maxima found (updated).
+   * @param n Count of input values.
+   * @param in Array of input values.
+   * @param k Plateau start position (after a lower value).
+   */
+  inline int addPlateauMax (int *lmax, int &count, int n,
+                            const int *in, int k) const
+  {
+    int j = k;
+    while (j < n - 1 && in[j + 1] == in[k]) j++;
+    if (j < n - 1 && in[j + 1] < in[k]) lmax[count++] = k + (j - k) / 2;
+    return j;
+  }
+
   /**
    * \brief Sorts the candidates array by highest magnitude.
+   * Candidates with equal magnitudes keep their order.
+   * @param lmax Local max index array.
+   * @param n Size of index array.
+   * @param val Input values.
+   * @param nbsorted Count of sorted candidates (all if negative).
+   */
+  void sortMax (int *lmax, int n, int *val, int nbsorted = -1) const;
+
+  /**
+   * \brief Brings the largest of the unsorted candidates at given position.
+   * The order of the other unsorted candidates is preserved.
    * @param lmax Local max index array.
+   * @param i Position of the selected candidate.
    * @param n Size of index array.
    * @param val Input values.
    */
-  void sortMax (int *lmax, int n, int *val) const;
+  void selectMax (int *lmax, int i, int n, const int *val) const;
 };
 
 #endif
@@ -37,6 +37,12 @@ bool Vr2i::orientedAs (const Vr2i &ref) const
 
 
 bool *Vr2i::steps (int *n) const
+{
+  return (steps (n, new bool[chessboard ()]));
+}
+
+
+bool *Vr2i::steps (int *n, bool *st) const
 {
   int x2 = (xv > 0 ? xv : - xv);
   int y2 = (yv > 0 ? yv : - yv);
@@ -49,7 +55,7 @@ bool *Vr2i::steps (int *n) const
   }
   int e, x = 0, i = 0;
   *n = x2;
-  bool *paliers = new bool[x2];
+  bool *paliers = st;
 
   e = dx;
   dx *= 2;
@@ -168,6 +168,15 @@ public:
    */
   bool *steps (int *n) const;
 
+  /**
+   * @fn bool *steps (int *n, bool *st)
+   * \brief Fills in the location of the steps between the vector ends.
+   * Returns the provided array.
+   * @param n size of the filled in array.
+   * @param st array to fill in, at least as long as the chessboard length.
+   */
+  bool *steps (int *n, bool *st) const;
+
 
 private:
 
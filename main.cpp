@@ -11,6 +11,7 @@ int main (int argc, char *argv[])
   int imageName = 0;
   bool random = false, testing = false;
   bool out = false;
+  bool parallel = false;
   QApplication app (argc, argv);
 
   BSWindow window (&val);   // val : necessary argument !
@@ -21,6 +22,7 @@ int main (int argc, char *argv[])
       if (string(argv[i]) == string ("-random")) random = true;
       else if (string(argv[i]) == string ("-test")) testing = true;
       else if (string(argv[i]) == string ("-out")) out = true;
+      else if (string(argv[i]) == string ("-parallel")) parallel = true;
       else if (string(argv[i]) == string ("-sobel3x3"))
         window.useGradient (VMap::TYPE_SOBEL_3X3);
       else if (string(argv[i]) == string ("-sobel5x5"))
@@ -70,6 +72,7 @@ int main (int argc, char *argv[])
     if (gMap != NULL) delete gMap;
     gMap = new VMap (width, height, tabImage, VMap::TYPE_SOBEL_5X5);
     detector.setGradientMap (gMap);
+    if (parallel) detector.switchParallelDetection ();
     // buildGradientImage (0);
     detector.detectAll ();
     ofstream outf ("naivelines.txt", ios::out);